@@ -0,0 +1,132 @@
+// Counts global heap allocations per keystroke once filtering has warmed
+// up. Types and erases a set of queries character by character, a few
+// rounds to warm the buffers, then again while counting: through the engine
+// (with and without the result cache, sequential and parallel) and through
+// the search worker. Exits non-zero if a measured keystroke allocated.
+//
+// Usage: allocation_check [titles] [rounds]
+
+#include "AllocationCounter.h"
+#include "CorpusGenerator.h"
+#include "SearchEngine.h"
+#include "SearchWorker.h"
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    // Every prefix of every query, then back down to the empty query
+    std::vector<std::wstring> Keystrokes() {
+        std::vector<std::wstring> keystrokes;
+        for (const std::wstring& query : CorpusGenerator::Queries()) {
+            for (size_t length = 1; length <= query.size(); ++length) {
+                keystrokes.push_back(query.substr(0, length));
+            }
+            for (size_t length = query.size(); length-- > 0;) {
+                keystrokes.push_back(query.substr(0, length));
+            }
+        }
+        return keystrokes;
+    }
+
+    constexpr size_t kWarmupRounds = 3;
+
+    template <typename TypeOne>
+    size_t Measure(const std::vector<std::wstring>& keystrokes, size_t rounds, TypeOne typeOne) {
+        for (size_t round = 0; round < kWarmupRounds; ++round) {
+            for (const std::wstring& query : keystrokes) {
+                typeOne(query);
+            }
+        }
+
+        AllocationCounter::Start();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (const std::wstring& query : keystrokes) {
+                typeOne(query);
+            }
+        }
+        return AllocationCounter::Stop();
+    }
+
+    bool Report(const char* name, size_t allocations, size_t keystrokes) {
+        std::printf("%-28s %10zu allocations  %8.3f per keystroke\n", name, allocations,
+                    static_cast<double>(allocations) / static_cast<double>(keystrokes));
+        return allocations == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t titles = 300;
+    size_t rounds = 3;
+    if (argc > 1) titles = std::max(std::strtoul(argv[1], nullptr, 10), 1ul);
+    if (argc > 2) rounds = std::max(std::strtoul(argv[2], nullptr, 10), 1ul);
+
+    const size_t rankHint = 20;
+    const std::vector<std::wstring> keystrokes = Keystrokes();
+    const size_t measured = keystrokes.size() * rounds;
+
+    auto snapshot = std::make_shared<SearchSnapshot>();
+    const auto windows = CorpusGenerator::Generate(titles, 42, true);
+    CorpusGenerator::BuildCorpus(windows, snapshot->corpus);
+    snapshot->frecencyKeys.assign(windows.size(), 0);
+    snapshot->generation = 1;
+
+    std::printf("corpus %zu titles, %zu keystrokes x %zu rounds\n", titles, keystrokes.size(), rounds);
+    bool clean = true;
+
+    {
+        SearchEngine engine;
+        SearchResults results;
+        clean &= Report("engine, cached", Measure(keystrokes, rounds, [&](const std::wstring& query) {
+            engine.Filter(snapshot->corpus, 1, query, rankHint, results);
+        }), measured);
+    }
+    {
+        SearchEngine engine;
+        engine.SetCacheCapacity(0);
+        SearchResults results;
+        clean &= Report("engine, uncached", Measure(keystrokes, rounds, [&](const std::wstring& query) {
+            engine.Filter(snapshot->corpus, 1, query, rankHint, results);
+        }), measured);
+    }
+    {
+        SearchEngine engine;
+        engine.SetCacheCapacity(0);
+        engine.SetParallelThreshold(1);
+        engine.SetWorkerCount(2);
+        SearchResults results;
+        clean &= Report("engine, uncached, parallel", Measure(keystrokes, rounds, [&](const std::wstring& query) {
+            engine.Filter(snapshot->corpus, 1, query, rankHint, results);
+        }), measured);
+    }
+    {
+        std::mutex mutex;
+        std::condition_variable ready;
+        uint64_t done = 0;
+        std::shared_ptr<const SearchSnapshot> published = snapshot;
+
+        SearchWorker worker([&] { return published; }, [&](uint64_t request) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = request;
+            ready.notify_one();
+        });
+        worker.Engine().SetCacheCapacity(0);
+        worker.Start();
+
+        SearchWorker::Response response;
+        clean &= Report("worker, uncached", Measure(keystrokes, rounds, [&](const std::wstring& query) {
+            const uint64_t request = worker.Submit(query, rankHint);
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [&] { return done == request; });
+            lock.unlock();
+            worker.TakeResponse(response);
+        }), measured);
+    }
+
+    std::printf(clean ? "no allocations in steady state\n" : "steady state allocates\n");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> g_allocations{0};
+    std::atomic<bool> g_counting{false};
+
+    void* Allocate(size_t size) {
+        if (g_counting.load(std::memory_order_relaxed)) {
+            g_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* p = std::malloc(size ? size : 1)) return p;
+        throw std::bad_alloc();
+    }
+}
+
+namespace AllocationCounter {
+    void Start() {
+        g_allocations.store(0);
+        g_counting.store(true);
+    }
+
+    size_t Stop() {
+        g_counting.store(false);
+        return g_allocations.load();
+    }
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
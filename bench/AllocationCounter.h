@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts global operator new calls made while counting is on, by replacing
+// the global allocation functions. Link AllocationCounter.cpp into a bench
+// executable directly, never into a library.
+namespace AllocationCounter {
+    void Start(); // Resets the count
+    size_t Stop(); // Allocations since Start()
+}
@@ -0,0 +1,128 @@
+#include "CorpusGenerator.h"
+
+namespace {
+    // Small fixed PRNG; std distributions differ between standard libraries
+    class Random {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed ? seed : 0x9E3779B9u) {}
+
+        uint32_t Next() {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+        size_t Below(size_t bound) { return Next() % bound; }
+
+        template <typename T, size_t N>
+        const T& Pick(const T (&items)[N]) { return items[Below(N)]; }
+
+    private:
+        uint32_t m_state;
+    };
+
+    struct Application {
+        const wchar_t* title;
+        const wchar_t* process;
+    };
+
+    const Application kApplications[] = {
+        { L"Visual Studio Code", L"Code.exe" },
+        { L"Google Chrome", L"chrome.exe" },
+        { L"Mozilla Firefox", L"firefox.exe" },
+        { L"Microsoft Edge", L"msedge.exe" },
+        { L"Outlook", L"OUTLOOK.EXE" },
+        { L"Word", L"WINWORD.EXE" },
+        { L"Excel", L"EXCEL.EXE" },
+        { L"File Explorer", L"explorer.exe" },
+        { L"Windows Terminal", L"WindowsTerminal.exe" },
+        { L"Slack", L"slack.exe" },
+        { L"Microsoft Teams", L"ms-teams.exe" },
+        { L"Notepad++", L"notepad++.exe" },
+        { L"Spotify", L"Spotify.exe" },
+        { L"Discord", L"Discord.exe" },
+        { L"Visual Studio", L"devenv.exe" },
+        { L"GIMP", L"gimp-2.10.exe" },
+    };
+
+    const wchar_t* const kWords[] = {
+        L"README", L"main", L"config", L"report", L"invoice", L"budget", L"meeting",
+        L"notes", L"draft", L"release", L"build", L"search", L"window", L"switcher",
+        L"project", L"design", L"review", L"sprint", L"planning", L"inbox", L"calendar",
+        L"github", L"pull", L"request", L"issue", L"docs", L"tutorial", L"weather",
+        L"news", L"music", L"playlist", L"video", L"photo", L"holiday", L"quarterly",
+    };
+
+    const wchar_t* const kExtensions[] = {
+        L".cpp", L".h", L".md", L".txt", L".json", L".docx", L".xlsx", L".py", L".ini",
+    };
+
+    const wchar_t* const kForeignWords[] = {
+        L"Übersicht", L"Größe", L"café", L"résumé", L"Ñandú", L"Łódź", L"Ærø",
+        L"Документ", L"Отчёт", L"Почта", L"Ελληνικά", L"Αρχείο",
+        L"検索", L"設定", L"ファイル", L"문서", L"报告",
+    };
+}
+
+namespace CorpusGenerator {
+    std::vector<SyntheticWindow> Generate(size_t count, uint32_t seed, bool mixedScripts) {
+        Random random(seed);
+        std::vector<SyntheticWindow> windows;
+        windows.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const Application& app = random.Pick(kApplications);
+            std::wstring title;
+
+            // Mostly short titles, with the long tail of browser tabs and
+            // documents that real sessions have
+            const size_t shape = random.Below(10);
+            const size_t words = shape < 6 ? 1 + random.Below(3) : shape < 9 ? 4 + random.Below(4) : 8 + random.Below(9);
+            if (random.Below(8) == 0) {
+                title += L"C:\\Users\\dev\\";
+                title += random.Pick(kWords);
+                title += L"\\";
+            }
+            for (size_t w = 0; w < words; ++w) {
+                if (w > 0) title += random.Below(3) == 0 ? L"_" : L" ";
+                if (mixedScripts && random.Below(4) == 0) {
+                    title += random.Pick(kForeignWords);
+                } else {
+                    title += random.Pick(kWords);
+                }
+            }
+            if (random.Below(2) == 0) {
+                title += random.Pick(kExtensions);
+            }
+            if (random.Below(5) == 0) {
+                title += L" (" + std::to_wstring(random.Below(100)) + L")";
+            }
+            title += L" - ";
+            title += app.title;
+
+            windows.push_back({ title, app.process });
+        }
+        return windows;
+    }
+
+    void BuildCorpus(const std::vector<SyntheticWindow>& windows, SearchCorpus& corpus) {
+        size_t chars = 0;
+        for (const auto& window : windows) {
+            chars += window.title.size() + window.processName.size();
+        }
+
+        corpus.Clear();
+        corpus.Reserve(windows.size(), chars);
+        for (size_t i = 0; i < windows.size(); ++i) {
+            corpus.Add(windows[i].title, windows[i].processName, static_cast<uint32_t>(i));
+        }
+    }
+
+    std::vector<std::wstring> Queries() {
+        return {
+            L"c", L"ch", L"chr", L"code", L"readme", L"vsc", L"inbox outlook",
+            L"budget xlsx", L"switcher main.cpp", L"spotfy", L"qqzx",
+        };
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "SearchCorpus.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A window as far as the search core is concerned.
+struct SyntheticWindow {
+    std::wstring title;
+    std::wstring processName;
+};
+
+// Deterministic window-title corpora for the headless benchmarks. The same
+// count and seed produce the same titles on every platform. Title lengths
+// follow a long-tailed mix: mostly one to three words, some up to sixteen,
+// some behind a path.
+namespace CorpusGenerator {
+    // `mixedScripts` adds accented Latin, Cyrillic, Greek and CJK titles to
+    // the mostly ASCII mix
+    std::vector<SyntheticWindow> Generate(size_t count, uint32_t seed, bool mixedScripts = false);
+
+    void BuildCorpus(const std::vector<SyntheticWindow>& windows, SearchCorpus& corpus);
+
+    // Typical queries against the generated titles, from one letter up to
+    // multi-word, including some that match nothing
+    std::vector<std::wstring> Queries();
+}
@@ -0,0 +1,140 @@
+// Compares EditDistancePattern against the O(m*n) dynamic programming table
+// it replaced. Random pairs over small and large alphabets, lengths around
+// the 64-character word boundary and patterns of several blocks, then
+// adversarial cases: empty strings, long runs of one character, periodic
+// patterns, characters outside Latin-1 and texts far longer than the pattern.
+// Exits non-zero on the first mismatch.
+//
+// Usage: edit_distance_check [pairs] [seed]
+
+#include "EditDistance.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Random {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    // The classic two-row table
+    size_t ReferenceDistance(const std::wstring& a, const std::wstring& b) {
+        std::vector<size_t> previous(b.size() + 1), current(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j) previous[j] = j;
+        for (size_t i = 1; i <= a.size(); ++i) {
+            current[0] = i;
+            for (size_t j = 1; j <= b.size(); ++j) {
+                const size_t substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+                current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+            }
+            previous.swap(current);
+        }
+        return previous[b.size()];
+    }
+
+    // Latin-1 letters, a few accented ones and some characters from other scripts
+    const wchar_t kAlphabet[] = L"abcdefghijklmnopqrstuvwxyz0123456789 ._-éüßЖλ中文—";
+
+    std::wstring RandomString(Random& random, size_t length, uint32_t alphabetSize) {
+        std::wstring text(length, L' ');
+        for (wchar_t& c : text) c = kAlphabet[random.Below(alphabetSize)];
+        return text;
+    }
+
+    size_t RandomLength(Random& random) {
+        switch (random.Below(4)) {
+        case 0: return random.Below(16);
+        case 1: return 60 + random.Below(10);   // Around one word
+        case 2: return 124 + random.Below(10);  // Around two words
+        default: return random.Below(300);
+        }
+    }
+
+    bool Check(const std::wstring& pattern, const std::wstring& text, size_t& compared) {
+        const EditDistancePattern compiled(pattern);
+        const size_t expected = ReferenceDistance(pattern, text);
+        const size_t actual = compiled.Distance(text);
+        ++compared;
+        if (expected == actual) return true;
+        std::printf("mismatch: pattern of %zu characters, text of %zu characters: expected %zu, got %zu\n",
+                    pattern.size(), text.size(), expected, actual);
+        return false;
+    }
+
+    std::wstring Repeat(const std::wstring& unit, size_t length) {
+        std::wstring text;
+        while (text.size() < length) text += unit;
+        text.resize(length);
+        return text;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t pairs = 20000;
+    Random random{ 88172645u };
+    if (argc > 1) pairs = std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 1);
+    if (argc > 2) random.state = std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)), 1);
+
+    const uint32_t alphabetSize = static_cast<uint32_t>(sizeof(kAlphabet) / sizeof(kAlphabet[0]) - 1);
+    size_t compared = 0;
+    size_t multiWord = 0;
+
+    // Random pairs, sometimes with the text derived from the pattern by a few edits
+    for (size_t i = 0; i < pairs; ++i) {
+        const uint32_t alphabet = random.Below(3) == 0 ? 2 + random.Below(3) : alphabetSize;
+        const std::wstring pattern = RandomString(random, RandomLength(random), alphabet);
+        std::wstring text;
+        if (random.Below(2) == 0 || pattern.empty()) {
+            text = RandomString(random, RandomLength(random), alphabet);
+        } else {
+            text = pattern;
+            for (uint32_t edits = random.Below(8); edits > 0; --edits) {
+                const size_t at = text.empty() ? 0 : random.Below(static_cast<uint32_t>(text.size()));
+                switch (random.Below(3)) {
+                case 0: text.insert(text.begin() + at, kAlphabet[random.Below(alphabet)]); break;
+                case 1: if (!text.empty()) text.erase(text.begin() + at); break;
+                default: if (!text.empty()) text[at] = kAlphabet[random.Below(alphabet)]; break;
+                }
+            }
+        }
+        multiWord += pattern.size() > 64;
+        if (!Check(pattern, text, compared)) return 1;
+    }
+
+    // Adversarial cases
+    const size_t lengths[] = { 0, 1, 2, 63, 64, 65, 127, 128, 129, 200, 513 };
+    const std::wstring units[] = { L"a", L"ab", L"abc", L"aab", L"中", L"aЖ", L"ée" };
+    for (size_t patternLength : lengths) {
+        for (size_t textLength : lengths) {
+            for (const std::wstring& unit : units) {
+                const std::wstring pattern = Repeat(unit, patternLength);
+                if (!Check(pattern, Repeat(unit, textLength), compared)) return 1;
+                if (!Check(pattern, Repeat(L"b", textLength), compared)) return 1;
+                if (!Check(pattern, Repeat(unit + L"x", textLength), compared)) return 1;
+                // The pattern reversed: every block boundary carries a delta
+                if (!Check(pattern, std::wstring(pattern.rbegin(), pattern.rend()), compared)) return 1;
+                multiWord += 4 * (patternLength > 64);
+            }
+        }
+    }
+    // Texts much longer than the pattern, with the pattern buried at the end
+    for (size_t patternLength : lengths) {
+        const std::wstring pattern = RandomString(random, patternLength, alphabetSize);
+        if (!Check(pattern, Repeat(L"z", 4000) + pattern, compared)) return 1;
+        if (!Check(pattern, RandomString(random, 4000, 4), compared)) return 1;
+        multiWord += 2 * (patternLength > 64);
+    }
+
+    std::printf("%zu distances compared, %zu with patterns longer than 64 characters\n", compared, multiWord);
+    std::printf("bit-parallel distance matches the dynamic programming table\n");
+    return 0;
+}
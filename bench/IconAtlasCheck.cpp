@@ -0,0 +1,155 @@
+// Exercises IconAtlas the way the switcher does: icons keyed by identity
+// come and go across snapshots while rows keep drawing from their cells.
+// After every sweep each live icon must still hold its own pixels, no two
+// icons may share a cell, and the atlas may not grow past the most icons
+// ever live at once. Also checks that the black/white render trick
+// recovers premultiplied pixels. Exits non-zero on the first failure.
+//
+// Usage: icon_atlas_check [rounds] [cell size]
+
+#include "IconAtlas.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct Random {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    // Distinct, recognisable pixels for every icon
+    uint32_t PixelOf(IconAtlas::Key key, size_t i) {
+        return static_cast<uint32_t>(key * 2654435761u + i * 40503u) | 0xFF000000u;
+    }
+
+    bool HoldsIcon(const IconAtlas& atlas, IconAtlas::Key key) {
+        const IconAtlas::Cell* cell = atlas.Find(key);
+        if (!cell) return false;
+        const int size = atlas.CellSize();
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const uint32_t pixel = atlas.Pixels()[static_cast<size_t>(cell->y + y) * atlas.Width() + cell->x + x];
+                if (pixel != PixelOf(key, static_cast<size_t>(y) * size + x)) return false;
+            }
+        }
+        return true;
+    }
+
+    // Composes straight-alpha pixels over black and white, as GDI would,
+    // and checks the recovered pixels against Premultiply()
+    size_t CheckBlackAndWhite(Random& random) {
+        const size_t count = 4096;
+        std::vector<uint32_t> onBlack(count), onWhite(count), recovered(count), expected(count);
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t straight = random.Next();
+            const uint32_t alpha = straight >> 24;
+            expected[i] = IconAtlas::Premultiply(straight);
+            uint32_t black = 0, white = 0;
+            for (int shift = 0; shift < 24; shift += 8) {
+                const uint32_t channel = (straight >> shift) & 0xFF;
+                const uint32_t over = (channel * alpha + 127) / 255;
+                black |= over << shift;
+                white |= std::min<uint32_t>(over + 255 - alpha, 255) << shift;
+            }
+            onBlack[i] = black;
+            onWhite[i] = white;
+        }
+        IconAtlas::FromBlackAndWhite(onBlack.data(), onWhite.data(), recovered.data(), count);
+
+        size_t wrong = 0;
+        for (size_t i = 0; i < count; ++i) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                const int a = static_cast<int>((recovered[i] >> shift) & 0xFF);
+                const int b = static_cast<int>((expected[i] >> shift) & 0xFF);
+                if (std::abs(a - b) > 1) {
+                    ++wrong;
+                    break;
+                }
+            }
+        }
+        return wrong;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rounds = 2000;
+    int cellSize = 16;
+    if (argc > 1) rounds = std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 1);
+    if (argc > 2) cellSize = std::max(std::atoi(argv[2]), 1);
+
+    Random random{ 2463534242u };
+    IconAtlas atlas(cellSize);
+    std::vector<IconAtlas::Key> live;
+    std::vector<uint32_t> pixels(static_cast<size_t>(cellSize) * cellSize);
+    IconAtlas::Key nextKey = 1;
+    size_t mostLive = 0, inserted = 0, freed = 0, draws = 0;
+
+    for (size_t round = 0; round < rounds; ++round) {
+        // A new snapshot: some icons go, some arrive, some windows share one
+        std::vector<IconAtlas::Key> next;
+        for (IconAtlas::Key key : live) {
+            if (random.Below(10) != 0) next.push_back(key);
+        }
+        const uint32_t arriving = random.Below(live.size() < 20 ? 12 : live.size() > 150 ? 2 : 8);
+        for (uint32_t i = 0; i < arriving; ++i) {
+            next.push_back(!next.empty() && random.Below(3) == 0 ? next[random.Below(static_cast<uint32_t>(next.size()))]
+                                                                 : nextKey++);
+        }
+        live = std::move(next);
+        freed += atlas.Sweep(live);
+
+        // Rows draw: render on first sight only
+        for (IconAtlas::Key key : live) {
+            ++draws;
+            if (atlas.Find(key)) continue;
+            for (size_t i = 0; i < pixels.size(); ++i) pixels[i] = PixelOf(key, i);
+            atlas.Insert(key, pixels.data());
+            ++inserted;
+        }
+
+        const std::set<IconAtlas::Key> distinct(live.begin(), live.end());
+        mostLive = std::max(mostLive, distinct.size());
+        if (atlas.Size() != distinct.size()) {
+            std::printf("round %zu: %zu cells for %zu live icons\n", round, atlas.Size(), distinct.size());
+            return 1;
+        }
+        std::set<std::pair<int, int>> cells;
+        for (IconAtlas::Key key : distinct) {
+            if (!HoldsIcon(atlas, key)) {
+                std::printf("round %zu: icon %llu lost its pixels\n", round, static_cast<unsigned long long>(key));
+                return 1;
+            }
+            if (!cells.insert({ atlas.Find(key)->x, atlas.Find(key)->y }).second) {
+                std::printf("round %zu: two icons share a cell\n", round);
+                return 1;
+            }
+        }
+        const size_t rowsAllowed = (mostLive + IconAtlas::kColumns - 1) / IconAtlas::kColumns;
+        if (static_cast<size_t>(atlas.Height() / cellSize) > rowsAllowed) {
+            std::printf("round %zu: %d rows for at most %zu icons\n", round, atlas.Height() / cellSize, mostLive);
+            return 1;
+        }
+    }
+    std::printf("atlas: %zu rounds, %zu draws, %zu renders, %zu cells recycled, %d x %d pixels for up to %zu icons\n",
+                rounds, draws, inserted, freed, atlas.Width(), atlas.Height(), mostLive);
+
+    const size_t wrong = CheckBlackAndWhite(random);
+    if (wrong) {
+        std::printf("black/white recovery: %zu of 4096 pixels off by more than 1\n", wrong);
+        return 1;
+    }
+    std::printf("black/white recovery matches premultiplied pixels\n");
+    std::printf("atlas checks passed\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Checks that incremental filtering finds exactly what filtering from
+// scratch finds. Random sessions type, paste, erase and retype queries cut
+// from the corpus titles; after every keystroke an engine that narrows and
+// caches across keystrokes must return the same matches and scores as one
+// that starts over each time. Runs each scoring preset, sequential and
+// parallel. Exits non-zero on the first mismatch.
+//
+// Usage: narrowing_check [titles] [keystrokes] [seed]
+
+#include "CorpusGenerator.h"
+#include "SearchEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Random {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    // The next query of a session: mostly one more character of a title
+    // fragment, sometimes a paste, a backspace, a typo or a fresh start
+    std::wstring NextQuery(Random& random, const SearchCorpus& corpus, const std::wstring& query,
+                           std::wstring& target) {
+        const uint32_t action = random.Below(20);
+        if (target.empty() || action == 0 || query.size() >= target.size()) {
+            const size_t entry = random.Below(static_cast<uint32_t>(corpus.Size()));
+            const std::wstring title(corpus.Title(entry), corpus.TitleLength(entry));
+            const size_t from = title.empty() ? 0 : random.Below(static_cast<uint32_t>(title.size()));
+            target = title.substr(from, 2 + random.Below(30));
+            if (target.empty()) target = L"x";
+            return target.substr(0, 1);
+        }
+        if (action < 3 && !query.empty()) return query.substr(0, query.size() - 1);
+        if (action < 5) return target.substr(0, std::min(target.size(), query.size() + 2 + random.Below(8)));
+        if (action == 5) return query + static_cast<wchar_t>(L'a' + random.Below(26));
+        return target.substr(0, query.size() + 1);
+    }
+
+    bool SameMatches(const SearchResults& a, const SearchResults& b) {
+        std::vector<SearchMatch> left = a.Matches();
+        std::vector<SearchMatch> right = b.Matches();
+        const auto byEntry = [](const SearchMatch& x, const SearchMatch& y) { return x.entry < y.entry; };
+        std::sort(left.begin(), left.end(), byEntry);
+        std::sort(right.begin(), right.end(), byEntry);
+        if (left.size() != right.size()) return false;
+        for (size_t i = 0; i < left.size(); ++i) {
+            if (left[i].entry != right[i].entry || left[i].score != right[i].score) return false;
+        }
+        return true;
+    }
+
+    bool RunSession(const SearchCorpus& corpus, ScoringPreset preset, bool parallel, size_t keystrokes,
+                    uint32_t seed, const char* name) {
+        SearchEngine incremental;
+        SearchEngine scratch;
+        for (SearchEngine* engine : { &incremental, &scratch }) {
+            engine->SetScoringPreset(preset);
+            if (parallel) {
+                engine->SetParallelThreshold(1);
+                engine->SetWorkerCount(3);
+            }
+        }
+        scratch.SetCacheCapacity(0);
+
+        Random random{ seed };
+        SearchResults narrowed, full;
+        std::wstring query, target;
+        size_t matches = 0;
+        for (size_t i = 0; i < keystrokes; ++i) {
+            query = NextQuery(random, corpus, query, target);
+            incremental.Filter(corpus, 1, query, 20, narrowed);
+            scratch.Reset();
+            scratch.Filter(corpus, 1, query, 20, full);
+            if (!SameMatches(narrowed, full)) {
+                std::printf("%s: keystroke %zu: %zu matches incrementally, %zu from scratch\n", name, i,
+                            narrowed.Size(), full.Size());
+                return false;
+            }
+            matches += full.Size();
+        }
+        std::printf("%-28s %zu keystrokes, %zu matches\n", name, keystrokes, matches);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t titles = 1000;
+    size_t keystrokes = 1500;
+    uint32_t seed = 521288629u;
+    if (argc > 1) titles = std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 1);
+    if (argc > 2) keystrokes = std::max<size_t>(std::strtoul(argv[2], nullptr, 10), 1);
+    if (argc > 3) seed = std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)), 1);
+
+    SearchCorpus corpus;
+    CorpusGenerator::BuildCorpus(CorpusGenerator::Generate(titles, 7, true), corpus);
+
+    const struct {
+        ScoringPreset preset;
+        bool parallel;
+        const char* name;
+    } runs[] = {
+        { ScoringPreset::Balanced, false, "balanced" },
+        { ScoringPreset::Balanced, true, "balanced, parallel" },
+        { ScoringPreset::TitleOnly, false, "title-only" },
+        { ScoringPreset::ProcessFirst, false, "process-first" },
+    };
+    for (const auto& run : runs) {
+        if (!RunSession(corpus, run.preset, run.parallel, keystrokes, seed, run.name)) return 1;
+    }
+    std::printf("incremental filtering matches filtering from scratch\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Times SearchEngine::Filter on synthetic corpora with 1..N scoring threads
+// and checks that every thread count produces the same ranking.
+//
+// Usage: parallel_scaling_bench [max_threads] [repetitions]
+
+#include "CorpusGenerator.h"
+#include "SearchEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::vector<SearchMatch> FullRanking(SearchResults& results) {
+        std::vector<SearchMatch> ranking;
+        ranking.reserve(results.Size());
+        for (size_t rank = 0; rank < results.Size(); ++rank) {
+            ranking.push_back(results.At(rank));
+        }
+        return ranking;
+    }
+
+    bool SameRanking(const std::vector<SearchMatch>& a, const std::vector<SearchMatch>& b) {
+        return a.size() == b.size() &&
+               std::equal(a.begin(), a.end(), b.begin(), [](const SearchMatch& x, const SearchMatch& y) {
+                   return x.entry == y.entry && x.score == y.score;
+               });
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t repetitions = 5;
+    if (argc > 1) maxThreads = std::max(std::strtoul(argv[1], nullptr, 10), 1ul);
+    if (argc > 2) repetitions = std::max(std::strtoul(argv[2], nullptr, 10), 1ul);
+
+    const size_t rankHint = 20;
+    const std::vector<std::wstring> queries = CorpusGenerator::Queries();
+    bool deterministic = true;
+
+    for (size_t size : { 10000u, 50000u, 100000u }) {
+        SearchCorpus corpus;
+        CorpusGenerator::BuildCorpus(CorpusGenerator::Generate(size, 42), corpus);
+
+        // Sequential reference ranking for every query
+        std::vector<std::vector<SearchMatch>> reference;
+        {
+            SearchEngine engine;
+            SearchResults results;
+            for (const auto& query : queries) {
+                engine.Reset();
+                engine.Filter(corpus, 1, query, rankHint, results);
+                reference.push_back(FullRanking(results));
+            }
+        }
+
+        std::printf("corpus %zu titles, %zu queries x %zu repetitions\n", size, queries.size(), repetitions);
+        std::printf("  threads   ms/pass   ns/candidate   speedup\n");
+
+        double baseline = 0.0;
+        for (size_t threads = 1; threads <= maxThreads; ++threads) {
+            SearchEngine engine;
+            engine.SetParallelThreshold(1);
+            engine.SetWorkerCount(threads);
+            SearchResults results;
+
+            // Warm up the pool and check the ranking against the reference
+            for (size_t q = 0; q < queries.size(); ++q) {
+                engine.Reset();
+                engine.Filter(corpus, 1, queries[q], rankHint, results);
+                if (!SameRanking(FullRanking(results), reference[q])) {
+                    std::printf("  MISMATCH: %zu threads, query %zu\n", threads, q);
+                    deterministic = false;
+                }
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < repetitions; ++r) {
+                for (const auto& query : queries) {
+                    engine.Reset();
+                    engine.Filter(corpus, 1, query, rankHint, results);
+                }
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            const double passes = static_cast<double>(repetitions * queries.size());
+            const double ms = std::chrono::duration<double, std::milli>(elapsed).count() / passes;
+            if (threads == 1) baseline = ms;
+            std::printf("  %7zu %9.3f %14.1f %9.2fx\n", threads, ms, ms * 1e6 / static_cast<double>(size),
+                        baseline / ms);
+        }
+        std::printf("\n");
+    }
+
+    std::printf("%s\n", deterministic ? "rankings identical across thread counts" : "RANKINGS DIFFER");
+    return deterministic ? 0 : 1;
+}
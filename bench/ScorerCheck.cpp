@@ -0,0 +1,274 @@
+// Compares the fused single-pass scorer against the four separate scorers it
+// replaced (Levenshtein ratio, position, prefix and sequential), component
+// by component. Queries are cut from the target so that exact prefixes,
+// word starts, subsequences and typos all occur, and include queries longer
+// than 64 characters, which take the scorer's multi-word fallbacks. The old
+// prefix scorer only knew word starts after a space, so the fused scorer is
+// given exactly those. A second phase scores titles that open with
+// punctuation ("(3) Inbox", "[Draft] Spec") with their real word starts and
+// checks that the shift-and matcher and the fallback for long queries
+// apply the same prefix rule. Exits non-zero on the first mismatch.
+//
+// Usage: scorer_check [pairs] [seed]
+
+#include "SearchScorer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Random {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    // The scorers as they were before the fused engine, on folded input
+
+    size_t ReferenceDistance(const std::wstring& a, const std::wstring& b) {
+        std::vector<size_t> previous(b.size() + 1), current(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j) previous[j] = j;
+        for (size_t i = 1; i <= a.size(); ++i) {
+            current[0] = i;
+            for (size_t j = 1; j <= b.size(); ++j) {
+                const size_t substitution = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+                current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+            }
+            previous.swap(current);
+        }
+        return previous[b.size()];
+    }
+
+    double ReferenceFuzzy(const std::wstring& search, const std::wstring& target) {
+        const size_t m = search.size();
+        const size_t n = target.size();
+        if (m == 0) return n == 0 ? 100.0 : 0.0;
+        if (n == 0) return 0.0;
+        const double dist = static_cast<double>(ReferenceDistance(search, target));
+        return (1.0 - dist / static_cast<double>(std::max(m, n))) * 100.0;
+    }
+
+    double ReferencePosition(const std::wstring& search, const std::wstring& target) {
+        if (search.empty() || target.empty()) return 0.0;
+        double score = 0.0;
+        double penalty = 0.0;
+        size_t lastFound = 0;
+        for (wchar_t c : search) {
+            const size_t found = target.find(c, lastFound);
+            if (found != std::wstring::npos) {
+                score += 1.0 - (static_cast<double>(found) / target.size());
+                lastFound = found + 1;
+            } else {
+                penalty += 0.2;
+            }
+        }
+        score = (score / search.size()) * 100.0;
+        return std::max(0.0, score - (penalty * 100.0));
+    }
+
+    double ReferencePrefix(const std::wstring& search, const std::wstring& target) {
+        if (search.empty() || target.empty()) return 0.0;
+        if (target.find(search) == 0) return 100.0;
+        size_t pos = 0;
+        while ((pos = target.find(L' ', pos)) != std::wstring::npos) {
+            ++pos;
+            if (pos < target.size() && target.compare(pos, search.size(), search) == 0) return 80.0;
+        }
+        size_t matching = 0;
+        while (matching < std::min(search.size(), target.size()) && search[matching] == target[matching]) {
+            ++matching;
+        }
+        return matching > 0 ? (static_cast<double>(matching) / search.size()) * 60.0 : 0.0;
+    }
+
+    double ReferenceSequential(const std::wstring& search, const std::wstring& target) {
+        if (search.empty() || target.empty()) return 0.0;
+        size_t longest = 0, current = 0, matches = 0;
+        size_t s = 0, t = 0;
+        while (s < search.size() && t < target.size()) {
+            if (search[s] == target[t]) {
+                ++current;
+                ++matches;
+                ++s;
+                ++t;
+                longest = std::max(longest, current);
+            } else {
+                current = 0;
+                ++t;
+            }
+        }
+        if (matches == 0) return 0.0;
+        return (static_cast<double>(matches) / search.size()) * 60.0 +
+               (static_cast<double>(longest) / search.size()) * 40.0;
+    }
+
+    // Word starts as the old prefix scorer saw them: the first character
+    // and every character after a space
+    std::vector<uint16_t> SpaceWordStarts(const std::wstring& text) {
+        std::vector<uint16_t> starts;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (i == 0 || text[i - 1] == L' ') starts.push_back(static_cast<uint16_t>(i));
+        }
+        return starts;
+    }
+
+    // The prefix rule both scorer paths follow: 100 at the beginning, 80
+    // after whitespace or at a word start, else the leading characters
+    double RulePrefix(const std::wstring& search, const std::wstring& target, const std::vector<uint16_t>& starts) {
+        if (search.empty() || target.empty()) return 0.0;
+        if (target.compare(0, search.size(), search) == 0) return 100.0;
+        for (size_t j = 1; j < target.size(); ++j) {
+            const bool start = WordBoundaries::IsSpace(target[j - 1]) ||
+                               std::find(starts.begin(), starts.end(), j) != starts.end();
+            if (start && target.compare(j, search.size(), search) == 0) return 80.0;
+        }
+        size_t matching = 0;
+        while (matching < std::min(search.size(), target.size()) && search[matching] == target[matching]) {
+            ++matching;
+        }
+        return matching > 0 ? (static_cast<double>(matching) / search.size()) * 60.0 : 0.0;
+    }
+
+    const wchar_t kAlphabet[] = L"abcdeé中 ";
+
+    std::wstring RandomString(Random& random, size_t length, uint32_t alphabetSize) {
+        std::wstring text(length, L' ');
+        for (wchar_t& c : text) c = kAlphabet[random.Below(alphabetSize)];
+        return text;
+    }
+
+    // A query made from the target: a prefix, a slice from a word start, a
+    // subsequence, a slice with typos, or unrelated text
+    std::wstring QueryFor(Random& random, const std::wstring& target, uint32_t alphabetSize) {
+        const size_t n = target.size();
+        const size_t from = n == 0 ? 0 : random.Below(static_cast<uint32_t>(n));
+        const size_t length = 1 + random.Below(random.Below(4) == 0 ? 140 : 12);
+        switch (random.Below(6)) {
+        case 0: return target.substr(0, length);
+        case 1: {
+            const size_t space = target.find(L' ', from);
+            return space == std::wstring::npos ? target.substr(from, length) : target.substr(space + 1, length);
+        }
+        case 2: {
+            std::wstring query;
+            for (size_t i = from; i < n && query.size() < length; ++i) {
+                if (random.Below(3) == 0) query += target[i];
+            }
+            return query;
+        }
+        case 3: {
+            std::wstring query = target.substr(from, length);
+            for (wchar_t& c : query) {
+                if (random.Below(6) == 0) c = kAlphabet[random.Below(alphabetSize)];
+            }
+            return query;
+        }
+        default: return RandomString(random, length, alphabetSize);
+        }
+    }
+
+    bool Near(double a, double b) { return std::fabs(a - b) < 1e-9; }
+
+    bool Check(const std::wstring& query, const std::wstring& target, size_t& compared, size_t& longQueries) {
+        const SearchScorer scorer(query);
+        const std::vector<uint16_t> starts = SpaceWordStarts(target);
+        const MatchComponents actual =
+            scorer.ScoreComponents(target.data(), target.size(), WordStarts{ starts.data(), starts.size() });
+        const MatchComponents expected{ ReferenceFuzzy(query, target), ReferencePosition(query, target),
+                                        ReferencePrefix(query, target), ReferenceSequential(query, target) };
+        ++compared;
+        longQueries += query.size() > 64;
+        if (Near(actual.fuzzy, expected.fuzzy) && Near(actual.position, expected.position) &&
+            Near(actual.prefix, expected.prefix) && Near(actual.sequential, expected.sequential)) {
+            return true;
+        }
+        std::printf("mismatch: query of %zu characters, target of %zu characters\n", query.size(), target.size());
+        std::printf("  fuzzy %.6f / %.6f  position %.6f / %.6f  prefix %.6f / %.6f  sequential %.6f / %.6f\n",
+                    actual.fuzzy, expected.fuzzy, actual.position, expected.position, actual.prefix, expected.prefix,
+                    actual.sequential, expected.sequential);
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t pairs = 50000;
+    Random random{ 362436069u };
+    if (argc > 1) pairs = std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 1);
+    if (argc > 2) random.state = std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)), 1);
+
+    const uint32_t alphabetSize = static_cast<uint32_t>(sizeof(kAlphabet) / sizeof(kAlphabet[0]) - 1);
+    size_t compared = 0;
+    size_t longQueries = 0;
+
+    for (size_t i = 0; i < pairs; ++i) {
+        const uint32_t alphabet = random.Below(2) == 0 ? 3 + random.Below(3) : alphabetSize;
+        const size_t length = random.Below(4) == 0 ? random.Below(400) : random.Below(60);
+        const std::wstring target = RandomString(random, length, alphabet);
+        if (!Check(QueryFor(random, target, alphabet), target, compared, longQueries)) return 1;
+    }
+
+    // Fixed cases for each component
+    const std::wstring longWord(100, L'a');
+    const std::pair<std::wstring, std::wstring> cases[] = {
+        { L"visual", L"visual studio code" },         // Exact prefix
+        { L"studio", L"visual studio code" },         // Word start
+        { L"vsc", L"visual studio code" },            // Subsequence
+        { L"vsiual", L"visual studio code" },         // Typo
+        { L"code", L"visual  studio  code" },         // Word start after two spaces
+        { L"", L"visual studio code" },
+        { L"visual", L"" },
+        { L"", L"" },
+        { longWord, longWord + L" tail" },            // Long exact prefix
+        { longWord, L"head " + longWord },            // Long word start
+        { longWord + L"b", longWord + L"c" },         // Long leading characters
+        { longWord, std::wstring(50, L'a') },         // Long query, short target
+    };
+    for (const auto& [query, target] : cases) {
+        if (!Check(query, target, compared, longQueries)) return 1;
+    }
+
+    std::printf("%zu query/target pairs compared, %zu with queries longer than 64 characters\n", compared,
+                longQueries);
+
+    // Punctuation-led titles: every prefix and every slice from a position
+    // after a space, short ones through the shift-and matcher and long ones
+    // through the fallback
+    const std::wstring padding = L" " + longWord + L" lorem ipsum dolor sit amet consectetur";
+    const std::wstring titles[] = {
+        L"(3) inbox", L"[draft] spec", L"#general | slack", L"*untitled", L"\u00bfqu\u00e9? notas",
+        L"(12) inbox - mail", L"\"quoted\" title", L"...loading", L"  leading spaces",
+    };
+    size_t prefixCompared = 0;
+    for (const std::wstring& shortTitle : titles) {
+        for (const std::wstring& title : { shortTitle, shortTitle + padding }) {
+            std::vector<uint16_t> starts;
+            WordBoundaries::Find(title.data(), title.size(), starts);
+            const WordStarts words{ starts.data(), starts.size() };
+            for (size_t from = 0; from < title.size(); ++from) {
+                if (from > 0 && !WordBoundaries::IsSpace(title[from - 1])) continue;
+                for (size_t length = 1; from + length <= title.size(); ++length) {
+                    const std::wstring query = title.substr(from, length);
+                    const double actual = SearchScorer(query).ScoreComponents(title.data(), title.size(), words).prefix;
+                    const double expected = RulePrefix(query, title, starts);
+                    ++prefixCompared;
+                    if (!Near(actual, expected)) {
+                        std::printf("prefix mismatch: query of %zu characters at offset %zu: %.6f, expected %.6f\n",
+                                    query.size(), from, actual, expected);
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+    std::printf("%zu prefixes of punctuation-led titles compared\n", prefixCompared);
+    std::printf("fused scorer matches the separate scorers\n");
+    return 0;
+}
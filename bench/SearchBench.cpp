@@ -0,0 +1,229 @@
+// Micro-benchmarks for the search path, with no window system involved:
+// the edit distance kernel, the scorer, acronym matching, the prefilter, a
+// full filter pass with ranking of the first page, and corpus construction.
+// Runs against generated corpora of several sizes and queries of several
+// lengths, prints ns per candidate and allocations per run, and can save
+// everything as JSON to compare builds.
+//
+// Usage: search_bench [--sizes 100,1000,10000,100000] [--min-ms 200]
+//                     [--ascii] [--json results.json]
+
+#include "AllocationCounter.h"
+#include "CharMask.h"
+#include "CorpusGenerator.h"
+#include "EditDistance.h"
+#include "SearchEngine.h"
+#include "SearchScorer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Result {
+        std::string benchmark;
+        size_t titles = 0;
+        size_t queryLength = 0;  // 0 where no query is involved
+        double nsPerCandidate = 0.0;
+        double allocationsPerRun = 0.0;
+        size_t runs = 0;
+        size_t matches = 0;      // Keeps the work observable; also a sanity check
+    };
+
+    struct Options {
+        std::vector<size_t> sizes = { 100, 1000, 10000, 100000 };
+        double minMilliseconds = 200.0;
+        bool mixedScripts = true;
+        const char* jsonPath = nullptr;
+    };
+
+    // Prefixes of a long realistic query, from one keystroke up to past the
+    // 64 characters that fit the single-word edit distance kernel
+    std::vector<std::wstring> QueriesByLength() {
+        const std::wstring phrase =
+            L"switcher main.cpp visual studio code budget report quarterly xlsx excel planning notes draft";
+        std::vector<std::wstring> queries;
+        for (size_t length : { 1, 2, 4, 8, 16, 32, 80 }) {
+            queries.push_back(phrase.substr(0, length));
+        }
+        return queries;
+    }
+
+    // Median time of one run of `body`, repeated for at least `minMilliseconds`
+    template <typename Body>
+    Result Measure(const char* name, size_t titles, size_t queryLength, size_t candidates, double minMilliseconds,
+                   Body body) {
+        using Clock = std::chrono::steady_clock;
+        body(); // Warm-up: caches, arenas, lazily built pools
+
+        const auto minDuration = std::chrono::duration<double, std::milli>(minMilliseconds);
+        const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(minDuration);
+        std::vector<double> samples;
+        size_t matches = 0;
+        size_t allocations = 0;
+        do {
+            AllocationCounter::Start();
+            const Clock::time_point start = Clock::now();
+            matches = body();
+            const Clock::time_point stop = Clock::now();
+            allocations += AllocationCounter::Stop();
+            samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        } while (Clock::now() < end || samples.size() < 3);
+
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        Result result;
+        result.benchmark = name;
+        result.titles = titles;
+        result.queryLength = queryLength;
+        result.nsPerCandidate = samples[samples.size() / 2] / static_cast<double>(std::max<size_t>(candidates, 1));
+        result.allocationsPerRun = static_cast<double>(allocations) / static_cast<double>(samples.size());
+        result.runs = samples.size();
+        result.matches = matches;
+        return result;
+    }
+
+    void RunCorpus(size_t titles, const Options& options, std::vector<Result>& results) {
+        const std::vector<SyntheticWindow> windows = CorpusGenerator::Generate(titles, 42, options.mixedScripts);
+        const double minMs = options.minMilliseconds;
+
+        SearchCorpus corpus;
+        results.push_back(Measure("build_corpus", titles, 0, titles, minMs, [&] {
+            CorpusGenerator::BuildCorpus(windows, corpus);
+            return corpus.Size();
+        }));
+
+        for (const std::wstring& query : QueriesByLength()) {
+            const size_t length = query.size();
+
+            const EditDistancePattern pattern(query);
+            results.push_back(Measure("edit_distance", titles, length, titles, minMs, [&] {
+                size_t close = 0;
+                for (size_t i = 0; i < corpus.Size(); ++i) {
+                    close += pattern.Distance(corpus.Title(i), corpus.TitleLength(i)) <= length / 2;
+                }
+                return close;
+            }));
+
+            const SearchScorer scorer(query);
+            results.push_back(Measure("score_target", titles, length, titles, minMs, [&] {
+                size_t passed = 0;
+                for (size_t i = 0; i < corpus.Size(); ++i) {
+                    passed += scorer.ScoreTarget(corpus.Title(i), corpus.TitleLength(i), corpus.TitleWords(i)) >
+                              SearchScorer::kMatchThreshold;
+                }
+                return passed;
+            }));
+
+            results.push_back(Measure("acronym", titles, length, titles, minMs, [&] {
+                size_t passed = 0;
+                for (size_t i = 0; i < corpus.Size(); ++i) {
+                    passed += scorer.AcronymScore(corpus.Title(i), corpus.TitleWords(i)) > SearchScorer::kMatchThreshold;
+                }
+                return passed;
+            }));
+
+            const CharMaskPrefilter prefilter(query, &SearchScorer::MayMatchWithMissing);
+            std::vector<size_t> survivors;
+            survivors.reserve(corpus.Size());
+            results.push_back(Measure("prefilter", titles, length, titles, minMs, [&] {
+                survivors.clear();
+                prefilter.Filter(corpus.Masks(), corpus.Size(), survivors);
+                return survivors.size();
+            }));
+
+            // One keystroke as the switcher sees it: no cache, no narrowing,
+            // the first page ranked
+            SearchEngine engine;
+            engine.SetCacheCapacity(0);
+            SearchResults matches;
+            results.push_back(Measure("filter_rank", titles, length, titles, minMs, [&] {
+                engine.Reset();
+                engine.Filter(corpus, 1, query, 20, matches);
+                return matches.Size();
+            }));
+        }
+    }
+
+    void PrintTable(const std::vector<Result>& results) {
+        std::printf("%-14s %8s %6s %14s %12s %8s %8s\n", "benchmark", "titles", "query", "ns/candidate",
+                    "allocs/run", "runs", "matches");
+        for (const Result& r : results) {
+            std::printf("%-14s %8zu %6zu %14.2f %12.2f %8zu %8zu\n", r.benchmark.c_str(), r.titles, r.queryLength,
+                        r.nsPerCandidate, r.allocationsPerRun, r.runs, r.matches);
+        }
+    }
+
+    bool WriteJson(const char* path, const Options& options, const std::vector<Result>& results) {
+        FILE* file = std::fopen(path, "w");
+        if (!file) return false;
+
+#ifdef NDEBUG
+        const bool optimized = true;
+#else
+        const bool optimized = false;
+#endif
+        std::fprintf(file, "{\n  \"suite\": \"search_bench\",\n  \"optimized\": %s,\n  \"mixed_scripts\": %s,\n",
+                     optimized ? "true" : "false", options.mixedScripts ? "true" : "false");
+        std::fprintf(file, "  \"results\": [\n");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            // One record per line, so builds can be compared with a plain diff
+            std::fprintf(file,
+                         "    {\"benchmark\": \"%s\", \"titles\": %zu, \"query_length\": %zu, "
+                         "\"ns_per_candidate\": %.3f, \"allocations_per_run\": %.3f, \"runs\": %zu, "
+                         "\"matches\": %zu}%s\n",
+                         r.benchmark.c_str(), r.titles, r.queryLength, r.nsPerCandidate, r.allocationsPerRun, r.runs,
+                         r.matches, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+                options.sizes.clear();
+                for (const char* p = argv[++i]; *p;) {
+                    char* next = nullptr;
+                    const unsigned long size = std::strtoul(p, &next, 10);
+                    if (next == p || size == 0) return false;
+                    options.sizes.push_back(size);
+                    p = *next == ',' ? next + 1 : next;
+                }
+            } else if (std::strcmp(argv[i], "--min-ms") == 0 && hasValue) {
+                options.minMilliseconds = std::max(std::strtod(argv[++i], nullptr), 1.0);
+            } else if (std::strcmp(argv[i], "--ascii") == 0) {
+                options.mixedScripts = false;
+            } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+                options.jsonPath = argv[++i];
+            } else {
+                return false;
+            }
+        }
+        return !options.sizes.empty();
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: search_bench [--sizes 100,1000,...] [--min-ms N] [--ascii] [--json FILE]\n");
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (size_t titles : options.sizes) {
+        RunCorpus(titles, options, results);
+    }
+    PrintTable(results);
+
+    if (options.jsonPath && !WriteJson(options.jsonPath, options, results)) {
+        std::fprintf(stderr, "cannot write %s\n", options.jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Stress test for SnapshotPublisher: one writer publishes snapshots as
+// fast as it can while many readers pin them and check every value. A
+// reader must only ever see whole snapshots, generations must never go
+// backwards for it, and a pin taken after reading Generation() must be at
+// least that new. Every snapshot but the last must be freed once the
+// readers are done. Exits non-zero on the first violation.
+//
+// Meant to be built with ThreadSanitizer as well, which then checks that
+// publishing and pinning are free of data races:
+//   cmake -S . -B build-tsan -DCMAKE_BUILD_TYPE=RelWithDebInfo -DCMAKE_CXX_FLAGS=-fsanitize=thread
+//   cmake --build build-tsan --target snapshot_stress && build-tsan/snapshot_stress
+//
+// Usage: snapshot_stress [snapshots] [readers]
+
+#include "SnapshotPublisher.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> g_live{ 0 };
+
+    struct Snapshot {
+        uint64_t generation = 0;
+        std::vector<uint64_t> values; // All derived from the generation
+
+        explicit Snapshot(uint64_t generation)
+            : generation(generation)
+            , values(64 + generation % 64) {
+            for (size_t i = 0; i < values.size(); ++i) values[i] = Value(generation, i);
+            g_live.fetch_add(1, std::memory_order_relaxed);
+        }
+        ~Snapshot() { g_live.fetch_sub(1, std::memory_order_relaxed); }
+
+        static uint64_t Value(uint64_t generation, size_t i) { return generation * 0x9E3779B97F4A7C15ull + i; }
+
+        bool Whole() const {
+            if (values.size() != 64 + generation % 64) return false;
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (values[i] != Value(generation, i)) return false;
+            }
+            return true;
+        }
+    };
+
+    struct ReaderStats {
+        uint64_t pins = 0;
+        uint64_t distinct = 0; // Snapshots seen
+        bool failed = false;
+    };
+}
+
+int main(int argc, char** argv) {
+    uint64_t snapshots = 200000;
+    size_t readers = std::max(std::thread::hardware_concurrency(), 5u) - 1; // Never fewer than four
+    if (argc > 1) snapshots = std::max<uint64_t>(std::strtoull(argv[1], nullptr, 10), 1);
+    if (argc > 2) readers = std::max<size_t>(std::strtoul(argv[2], nullptr, 10), 1);
+
+    SnapshotPublisher<Snapshot> publisher;
+    std::atomic<bool> done{ false };
+    std::vector<ReaderStats> stats(readers);
+    std::vector<std::thread> threads;
+
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            ReaderStats& mine = stats[r];
+            uint64_t last = 0;
+            // Some readers hold on to a snapshot for a while, as a filter pass does
+            std::shared_ptr<const Snapshot> held;
+            while (!done.load(std::memory_order_acquire)) {
+                const uint64_t announced = publisher.Generation();
+                std::shared_ptr<const Snapshot> pinned = publisher.Pin();
+                ++mine.pins;
+                if (!pinned) {
+                    if (announced != 0) mine.failed = true;
+                    continue;
+                }
+                if (pinned->generation < last || pinned->generation < announced || !pinned->Whole()) {
+                    mine.failed = true;
+                    return;
+                }
+                mine.distinct += pinned->generation != last;
+                last = pinned->generation;
+                if (r % 2 == 0 && mine.pins % 64 == 0) held = std::move(pinned);
+                if (held && !held->Whole()) {
+                    mine.failed = true;
+                    return;
+                }
+            }
+        });
+    }
+
+    for (uint64_t generation = 1; generation <= snapshots; ++generation) {
+        publisher.Publish(std::make_shared<const Snapshot>(generation));
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& thread : threads) thread.join();
+
+    uint64_t pins = 0, distinct = 0;
+    bool failed = false;
+    for (const ReaderStats& mine : stats) {
+        pins += mine.pins;
+        distinct += mine.distinct;
+        failed |= mine.failed;
+    }
+    std::printf("%llu snapshots published, %zu readers, %llu pins, %llu snapshot changes seen\n",
+                static_cast<unsigned long long>(snapshots), readers, static_cast<unsigned long long>(pins),
+                static_cast<unsigned long long>(distinct));
+    if (failed) {
+        std::printf("a reader saw a torn, stale or out-of-order snapshot\n");
+        return 1;
+    }
+    if (g_live.load() != 1 || publisher.Generation() != snapshots) {
+        std::printf("%llu snapshots still alive after the readers finished\n",
+                    static_cast<unsigned long long>(g_live.load()));
+        return 1;
+    }
+    std::printf("snapshot publication is consistent\n");
+    return 0;
+}
@@ -0,0 +1,230 @@
+// Replays recorded switcher sessions (see KeystrokeTrace and [Trace] File in
+// config.ini) through the search worker, the same path OnChar/OnKeyDown
+// take in the switcher: fold the query, submit it, wait for the pass. Reports
+// per-keystroke latency percentiles and where the window the user finally
+// activated ended up in the ranking. Frecency is not part of the replay,
+// so ranks reflect the scorer alone.
+//
+// Usage: trace_replay <trace> [--preset balanced|title-only|process-first]
+//                             [--threshold N]
+//        trace_replay --generate <sessions> <trace>
+
+#include "CaseFold.h"
+#include "CorpusGenerator.h"
+#include "KeystrokeTrace.h"
+#include "SearchWorker.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Options {
+        const char* tracePath = nullptr;
+        ScoringPreset preset = ScoringPreset::Balanced;
+        size_t parallelThreshold = 4096; // The switcher's default
+    };
+
+    struct Report {
+        std::vector<double> latenciesUs;
+        size_t sessions = 0;
+        size_t ranked = 0;   // Sessions that typed a query and activated a window
+        size_t missing = 0;  // ... where that window was not among the matches
+        size_t top1 = 0;
+        size_t top3 = 0;
+        double rankSum = 0.0;
+        double reciprocalSum = 0.0;
+    };
+
+    std::shared_ptr<SearchSnapshot> BuildSnapshot(const KeystrokeTrace& session, uint64_t generation) {
+        auto snapshot = std::make_shared<SearchSnapshot>();
+        size_t chars = 0;
+        for (const auto& window : session.windows) {
+            chars += window.title.size() + window.processName.size();
+        }
+        snapshot->corpus.SetStripDiacritics(session.stripDiacritics);
+        snapshot->corpus.Reserve(session.windows.size(), chars);
+        for (size_t i = 0; i < session.windows.size(); ++i) {
+            const auto& window = session.windows[i];
+            snapshot->corpus.Add(window.title, window.processName, static_cast<uint32_t>(i));
+            snapshot->frecencyKeys.push_back(FrecencyStore::WindowKey(window.processName, window.title));
+        }
+        snapshot->generation = generation;
+        return snapshot;
+    }
+
+    void Replay(const std::vector<KeystrokeTrace>& sessions, const Options& options, Report& report) {
+        using Clock = std::chrono::steady_clock;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        uint64_t done = 0;
+        std::shared_ptr<const SearchSnapshot> published;
+
+        SearchWorker worker(
+            [&]() -> std::shared_ptr<const SearchSnapshot> {
+                std::lock_guard<std::mutex> lock(mutex);
+                return published;
+            },
+            [&](uint64_t request) {
+                std::lock_guard<std::mutex> lock(mutex);
+                done = request;
+                ready.notify_one();
+            });
+        worker.Engine().SetScoringPreset(options.preset);
+        worker.Engine().SetParallelThreshold(options.parallelThreshold);
+        worker.Start();
+
+        SearchWorker::Response response;
+        std::wstring folded;
+        for (size_t s = 0; s < sessions.size(); ++s) {
+            const KeystrokeTrace& session = sessions[s];
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                published = BuildSnapshot(session, s + 1);
+            }
+            ++report.sessions;
+
+            for (const auto& keystroke : session.keystrokes) {
+                folded.assign(keystroke.query);
+                CaseFold::Fold(folded, session.stripDiacritics);
+
+                const Clock::time_point start = Clock::now();
+                const uint64_t request = worker.Submit(folded, 20);
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&] { return done == request; });
+                }
+                report.latenciesUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                worker.TakeResponse(response);
+            }
+
+            if (session.keystrokes.empty() || session.keystrokes.back().query.empty() || session.chosen < 0) {
+                continue;
+            }
+            ++report.ranked;
+            // Corpus entries are built in window order
+            const size_t rank = response.results.RankOf(static_cast<uint32_t>(session.chosen));
+            if (rank >= response.results.Size()) {
+                ++report.missing;
+                continue;
+            }
+            report.top1 += rank == 0;
+            report.top3 += rank < 3;
+            report.rankSum += static_cast<double>(rank + 1);
+            report.reciprocalSum += 1.0 / static_cast<double>(rank + 1);
+        }
+    }
+
+    double Percentile(std::vector<double>& sorted, double p) {
+        if (sorted.empty()) return 0.0;
+        const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+        return sorted[index];
+    }
+
+    void Print(Report& report) {
+        std::vector<double>& latencies = report.latenciesUs;
+        std::sort(latencies.begin(), latencies.end());
+        std::printf("sessions %zu, keystrokes %zu\n", report.sessions, latencies.size());
+        std::printf("latency us   p50 %.1f   p90 %.1f   p99 %.1f   max %.1f\n", Percentile(latencies, 0.50),
+                    Percentile(latencies, 0.90), Percentile(latencies, 0.99),
+                    latencies.empty() ? 0.0 : latencies.back());
+
+        const size_t found = report.ranked - report.missing;
+        std::printf("chosen window: %zu ranked sessions, %zu not matched\n", report.ranked, report.missing);
+        if (found > 0) {
+            std::printf("rank   mean %.2f   top-1 %.1f%%   top-3 %.1f%%   MRR %.3f\n",
+                        report.rankSum / static_cast<double>(found),
+                        100.0 * static_cast<double>(report.top1) / static_cast<double>(report.ranked),
+                        100.0 * static_cast<double>(report.top3) / static_cast<double>(report.ranked),
+                        report.reciprocalSum / static_cast<double>(report.ranked));
+        }
+    }
+
+    // Synthetic sessions for trying the tool without a recording: the user
+    // types the start of the chosen window's first word, or the initials of
+    // its words
+    bool Generate(size_t count, const char* path) {
+        std::remove(path);
+        uint32_t state = 12345;
+        auto next = [&state] {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        };
+
+        for (size_t s = 0; s < count; ++s) {
+            KeystrokeTrace session;
+            for (const auto& window : CorpusGenerator::Generate(50 + next() % 200, next(), true)) {
+                session.windows.push_back({ window.title, window.processName });
+            }
+            session.chosen = next() % session.windows.size();
+
+            const std::wstring& title = session.windows[static_cast<size_t>(session.chosen)].title;
+            std::wstring typed;
+            if (next() % 3 == 0) {
+                for (size_t i = 0; i < title.size() && typed.size() < 4; ++i) {
+                    if ((i == 0 || title[i - 1] == L' ') && std::iswalpha(title[i])) typed += title[i];
+                }
+            } else {
+                typed = title.substr(0, std::min<size_t>(title.find(L' '), 3 + next() % 6));
+            }
+
+            uint32_t elapsed = 150;
+            for (size_t length = 1; length <= typed.size(); ++length) {
+                elapsed += 80 + next() % 120;
+                session.keystrokes.push_back({ elapsed, typed.substr(0, length) });
+            }
+            if (!session.AppendTo(path)) return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && std::strcmp(argv[1], "--generate") == 0) {
+        return Generate(std::strtoul(argv[2], nullptr, 10), argv[3]) ? 0 : 1;
+    }
+
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--preset") == 0 && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (!ParseScoringPreset(std::wstring(name.begin(), name.end()), options.preset)) {
+                options.tracePath = nullptr;
+                break;
+            }
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            options.parallelThreshold = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!options.tracePath && argv[i][0] != '-') {
+            options.tracePath = argv[i];
+        } else {
+            options.tracePath = nullptr;
+            break;
+        }
+    }
+    if (!options.tracePath) {
+        std::fprintf(stderr, "usage: trace_replay <trace> [--preset NAME] [--threshold N]\n"
+                             "       trace_replay --generate <sessions> <trace>\n");
+        return 2;
+    }
+
+    std::vector<KeystrokeTrace> sessions;
+    if (!KeystrokeTrace::Load(options.tracePath, sessions)) {
+        std::fprintf(stderr, "cannot read %s\n", options.tracePath);
+        return 1;
+    }
+
+    Report report;
+    Replay(sessions, options, report);
+    Print(report);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Drives WindowTracker from a scripted desktop: random creates, destroys,
+// shows, hides, renames, activations and minimizes, applied in batches of
+// events. After every batch the tracked list must equal a full
+// enumeration, order included. A second phase drops some events, as a
+// missed hook would, and checks that Reconcile() repairs the list. Every
+// batch's WindowDiff delta must rebuild the new list from the old one.
+// Exits non-zero on the first mismatch.
+//
+// Usage: window_tracker_check [steps] [seed]
+
+#include "ScriptedWindowSource.h"
+#include "WindowTracker.h"
+#include "WindowDiff.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Random {
+        uint32_t state;
+        uint32_t Next() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+        uint32_t Below(uint32_t n) { return Next() % n; }
+    };
+
+    // One random change to the desktop. Titles are never empty, so a window
+    // never becomes listed in place, which events cannot place in z-order
+    void Step(ScriptedWindowSource& source, Random& random, size_t step) {
+        const std::vector<WindowHandle> handles = source.Handles();
+        const uint32_t action = handles.size() < 5 ? 0 : handles.size() > 200 ? 1 : random.Below(8);
+        const WindowHandle target = handles.empty() ? 0 : handles[random.Below(static_cast<uint32_t>(handles.size()))];
+        const uint32_t process = random.Below(12);
+
+        switch (action) {
+        case 0:
+            source.Create(L"window " + std::to_wstring(step), L"app" + std::to_wstring(process) + L".exe", 1000 + process,
+                          random.Below(4) != 0);
+            break;
+        case 1: source.Destroy(target); break;
+        case 2: source.Show(target); break;
+        case 3: source.Hide(target); break;
+        case 4: source.Rename(target, L"renamed " + std::to_wstring(step)); break;
+        case 5: source.Activate(target); break;
+        case 6: source.SetMinimized(target, random.Below(2) != 0); break;
+        default:
+            source.Create(L"window " + std::to_wstring(step), L"app" + std::to_wstring(process) + L".exe", 1000 + process);
+            break;
+        }
+    }
+
+    // Rebuilds `after` from `before` and the delta alone
+    bool DeltaRebuilds(const std::vector<TrackedWindow>& before, const std::vector<TrackedWindow>& after,
+                       const WindowDelta& delta) {
+        if (delta.previous.size() != after.size()) return false;
+        std::vector<bool> kept(before.size(), false);
+        auto added = delta.added.begin();
+        auto changed = delta.changed.begin();
+        size_t lastKept = 0;
+        bool reordered = false;
+        for (size_t i = 0; i < after.size(); ++i) {
+            const size_t previous = delta.previous[i];
+            if (previous == WindowDelta::kNone) {
+                if (added == delta.added.end() || *added++ != i) return false;
+                continue;
+            }
+            if (previous >= before.size() || kept[previous]) return false;
+            kept[previous] = true;
+            reordered |= previous < lastKept;
+            lastKept = previous;
+
+            const bool isChanged = changed != delta.changed.end() && *changed == i;
+            if (isChanged) ++changed;
+            if (before[previous].handle != after[i].handle) return false;
+            if (isChanged == (before[previous] == after[i])) return false;
+        }
+        size_t removed = 0;
+        for (size_t i = 0; i < before.size(); ++i) {
+            if (!kept[i] && (removed >= delta.removed.size() || delta.removed[removed++] != i)) return false;
+        }
+        return added == delta.added.end() && changed == delta.changed.end() && removed == delta.removed.size() &&
+               reordered == delta.reordered;
+    }
+
+    bool Matches(ScriptedWindowSource& source, const WindowTracker& tracker) {
+        std::vector<TrackedWindow> expected;
+        source.Enumerate(expected);
+        return expected == tracker.Windows();
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t steps = 20000;
+    Random random{ 2463534242u };
+    if (argc > 1) steps = std::max<size_t>(std::strtoul(argv[1], nullptr, 10), 1);
+    if (argc > 2) random.state = std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)), 1);
+
+    ScriptedWindowSource source;
+    size_t notifications = 0;
+    source.Start([&] { ++notifications; });
+
+    WindowTracker tracker(source);
+    tracker.Reconcile();
+
+    std::vector<WindowEvent> events;
+    size_t batches = 0;
+    size_t eventCount = 0;
+
+    WindowDiff diff;
+    WindowDelta delta;
+    std::vector<TrackedWindow> before;
+    size_t added = 0, removed = 0, changed = 0, unchanged = 0;
+
+    // Every event delivered: the list must always be exact
+    for (size_t step = 0; step < steps; ++step) {
+        Step(source, random, step);
+        if (random.Below(4) != 0) continue; // Let events pile up into batches
+
+        events.clear();
+        source.TakeEvents(events);
+        eventCount += events.size();
+        before = tracker.Windows();
+        tracker.Apply(events);
+        ++batches;
+        if (!Matches(source, tracker)) {
+            std::printf("mismatch after step %zu (%zu events in the batch)\n", step, events.size());
+            return 1;
+        }
+
+        diff.Compute(before, tracker.Windows(), delta);
+        if (!DeltaRebuilds(before, tracker.Windows(), delta)) {
+            std::printf("delta does not rebuild the list after step %zu\n", step);
+            return 1;
+        }
+        added += delta.added.size();
+        removed += delta.removed.size();
+        changed += delta.changed.size();
+        unchanged += tracker.Windows().size() - delta.added.size() - delta.changed.size();
+    }
+    std::printf("events: %zu steps, %zu events in %zu batches, %zu notifications, %zu windows listed\n", steps,
+                eventCount, batches, notifications, tracker.Windows().size());
+    std::printf("deltas: %zu added, %zu removed, %zu changed, %zu entries kept as they were\n", added, removed, changed,
+                unchanged);
+
+    // Some events lost: reconciliation must repair the list
+    size_t stale = 0;
+    for (size_t step = 0; step < steps; ++step) {
+        source.SetDropEvents(random.Below(10) == 0);
+        Step(source, random, steps + step);
+        source.SetDropEvents(false);
+        if (random.Below(4) != 0) continue;
+
+        events.clear();
+        source.TakeEvents(events);
+        tracker.Apply(events);
+        stale += !Matches(source, tracker);
+        if (random.Below(8) == 0) {
+            tracker.Reconcile();
+            if (!Matches(source, tracker)) {
+                std::printf("reconciliation left the list out of date after step %zu\n", step);
+                return 1;
+            }
+        }
+    }
+    std::printf("dropped events: %zu stale batches, %llu corrections\n", stale,
+                static_cast<unsigned long long>(tracker.Corrections()));
+    std::printf("tracker matches the desktop\n");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "CaseFold.h"
+
+namespace CaseFold {
+    namespace {
+        template <size_t Blocks>
+        void FoldWith(const detail::Table<Blocks>& table, wchar_t* text, size_t length) {
+            for (size_t i = 0; i < length; ++i) {
+                text[i] = detail::Apply(table, text[i]);
+            }
+        }
+    }
+
+    void Fold(wchar_t* text, size_t length, bool stripDiacritics) {
+        // Pick the table once, not per character
+        if (stripDiacritics) {
+            FoldWith(detail::kBaseTable, text, length);
+        } else {
+            FoldWith(detail::kCaseTable, text, length);
+        }
+    }
+
+    void Fold(std::wstring& text, bool stripDiacritics) {
+        Fold(&text[0], text.size(), stripDiacritics);
+    }
+
+    std::wstring Folded(const std::wstring& text, bool stripDiacritics) {
+        std::wstring folded = text;
+        Fold(folded, stripDiacritics);
+        return folded;
+    }
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Locale-independent case folding for search, with optional diacritic
+// stripping ("É" -> "e"). The tables are generated at compile time from the
+// range lists below and looked up in two levels: the high byte of a BMP code
+// point selects a 256-entry block, the low byte an entry holding the offset
+// to the folded code point. Blocks without any mapping all share one zero
+// block. Folding never changes the length of a string; code points outside
+// the BMP and surrogates are left alone.
+namespace CaseFold {
+    namespace detail {
+        // Every `stride`-th code point in [first, last] maps to itself + delta
+        struct FoldRange {
+            uint16_t first;
+            uint16_t last;
+            int32_t delta;
+            uint8_t stride;
+        };
+
+        // Every code point in [first, last] strips to `base` (already folded)
+        struct StripRange {
+            uint16_t first;
+            uint16_t last;
+            uint16_t base;
+        };
+
+        // Simple case folding of the BMP (Unicode 14 CaseFolding.txt, status
+        // C and S), except that İ folds to i like towlower does.
+        constexpr FoldRange kFoldRanges[] = {
+            // Latin
+            { 0x0041, 0x005A, 0x0020, 1 }, { 0x00B5, 0x00B5, 0x0307, 1 }, { 0x00C0, 0x00D6, 0x0020, 1 },
+            { 0x00D8, 0x00DE, 0x0020, 1 }, { 0x0100, 0x012E, 1, 2 }, { 0x0130, 0x0130, -0x00C7, 1 },
+            { 0x0132, 0x0136, 1, 2 }, { 0x0139, 0x0147, 1, 2 }, { 0x014A, 0x0176, 1, 2 },
+            { 0x0178, 0x0178, -0x0079, 1 }, { 0x0179, 0x017D, 1, 2 }, { 0x017F, 0x017F, -0x010C, 1 },
+            { 0x0181, 0x0181, 0x00D2, 1 }, { 0x0182, 0x0184, 1, 2 }, { 0x0186, 0x0186, 0x00CE, 1 },
+            { 0x0187, 0x0187, 1, 1 }, { 0x0189, 0x018A, 0x00CD, 1 }, { 0x018B, 0x018B, 1, 1 },
+            { 0x018E, 0x018E, 0x004F, 1 }, { 0x018F, 0x018F, 0x00CA, 1 }, { 0x0190, 0x0190, 0x00CB, 1 },
+            { 0x0191, 0x0191, 1, 1 }, { 0x0193, 0x0193, 0x00CD, 1 }, { 0x0194, 0x0194, 0x00CF, 1 },
+            { 0x0196, 0x0196, 0x00D3, 1 }, { 0x0197, 0x0197, 0x00D1, 1 }, { 0x0198, 0x0198, 1, 1 },
+            { 0x019C, 0x019C, 0x00D3, 1 }, { 0x019D, 0x019D, 0x00D5, 1 }, { 0x019F, 0x019F, 0x00D6, 1 },
+            { 0x01A0, 0x01A4, 1, 2 }, { 0x01A6, 0x01A6, 0x00DA, 1 }, { 0x01A7, 0x01A7, 1, 1 },
+            { 0x01A9, 0x01A9, 0x00DA, 1 }, { 0x01AC, 0x01AC, 1, 1 }, { 0x01AE, 0x01AE, 0x00DA, 1 },
+            { 0x01AF, 0x01AF, 1, 1 }, { 0x01B1, 0x01B2, 0x00D9, 1 }, { 0x01B3, 0x01B5, 1, 2 },
+            { 0x01B7, 0x01B7, 0x00DB, 1 }, { 0x01B8, 0x01B8, 1, 1 }, { 0x01BC, 0x01BC, 1, 1 },
+            { 0x01C4, 0x01C4, 2, 1 }, { 0x01C5, 0x01C5, 1, 1 }, { 0x01C7, 0x01C7, 2, 1 },
+            { 0x01C8, 0x01C8, 1, 1 }, { 0x01CA, 0x01CA, 2, 1 }, { 0x01CB, 0x01DB, 1, 2 },
+            { 0x01DE, 0x01EE, 1, 2 }, { 0x01F1, 0x01F1, 2, 1 }, { 0x01F2, 0x01F4, 1, 2 },
+            { 0x01F6, 0x01F6, -0x0061, 1 }, { 0x01F7, 0x01F7, -0x0038, 1 }, { 0x01F8, 0x021E, 1, 2 },
+            { 0x0220, 0x0220, -0x0082, 1 }, { 0x0222, 0x0232, 1, 2 }, { 0x023A, 0x023A, 0x2A2B, 1 },
+            { 0x023B, 0x023B, 1, 1 }, { 0x023D, 0x023D, -0x00A3, 1 }, { 0x023E, 0x023E, 0x2A28, 1 },
+            { 0x0241, 0x0241, 1, 1 }, { 0x0243, 0x0243, -0x00C3, 1 }, { 0x0244, 0x0244, 0x0045, 1 },
+            { 0x0245, 0x0245, 0x0047, 1 }, { 0x0246, 0x024E, 1, 2 },
+            // Greek and Coptic
+            { 0x0345, 0x0345, 0x0074, 1 }, { 0x0370, 0x0372, 1, 2 }, { 0x0376, 0x0376, 1, 1 },
+            { 0x037F, 0x037F, 0x0074, 1 }, { 0x0386, 0x0386, 0x0026, 1 }, { 0x0388, 0x038A, 0x0025, 1 },
+            { 0x038C, 0x038C, 0x0040, 1 }, { 0x038E, 0x038F, 0x003F, 1 }, { 0x0391, 0x03A1, 0x0020, 1 },
+            { 0x03A3, 0x03AB, 0x0020, 1 }, { 0x03C2, 0x03C2, 1, 1 }, { 0x03CF, 0x03CF, 8, 1 },
+            { 0x03D0, 0x03D0, -0x001E, 1 }, { 0x03D1, 0x03D1, -0x0019, 1 }, { 0x03D5, 0x03D5, -0x000F, 1 },
+            { 0x03D6, 0x03D6, -0x0016, 1 }, { 0x03D8, 0x03EE, 1, 2 }, { 0x03F0, 0x03F0, -0x0036, 1 },
+            { 0x03F1, 0x03F1, -0x0030, 1 }, { 0x03F4, 0x03F4, -0x003C, 1 }, { 0x03F5, 0x03F5, -0x0040, 1 },
+            { 0x03F7, 0x03F7, 1, 1 }, { 0x03F9, 0x03F9, -7, 1 }, { 0x03FA, 0x03FA, 1, 1 },
+            { 0x03FD, 0x03FF, -0x0082, 1 },
+            // Cyrillic, Armenian, Georgian, Cherokee
+            { 0x0400, 0x040F, 0x0050, 1 }, { 0x0410, 0x042F, 0x0020, 1 }, { 0x0460, 0x0480, 1, 2 },
+            { 0x048A, 0x04BE, 1, 2 }, { 0x04C0, 0x04C0, 0x000F, 1 }, { 0x04C1, 0x04CD, 1, 2 },
+            { 0x04D0, 0x052E, 1, 2 }, { 0x0531, 0x0556, 0x0030, 1 }, { 0x10A0, 0x10C5, 0x1C60, 1 },
+            { 0x10C7, 0x10C7, 0x1C60, 1 }, { 0x10CD, 0x10CD, 0x1C60, 1 }, { 0x13F8, 0x13FD, -8, 1 },
+            { 0x1C80, 0x1C80, -0x184E, 1 }, { 0x1C81, 0x1C81, -0x184D, 1 }, { 0x1C82, 0x1C82, -0x1844, 1 },
+            { 0x1C83, 0x1C84, -0x1842, 1 }, { 0x1C85, 0x1C85, -0x1843, 1 }, { 0x1C86, 0x1C86, -0x183C, 1 },
+            { 0x1C87, 0x1C87, -0x1824, 1 }, { 0x1C88, 0x1C88, 0x89C3, 1 }, { 0x1C90, 0x1CBA, -0x0BC0, 1 },
+            { 0x1CBD, 0x1CBF, -0x0BC0, 1 },
+            // Latin Extended Additional
+            { 0x1E00, 0x1E94, 1, 2 }, { 0x1E9B, 0x1E9B, -0x003A, 1 }, { 0x1E9E, 0x1E9E, -0x1DBF, 1 },
+            { 0x1EA0, 0x1EFE, 1, 2 },
+            // Greek Extended
+            { 0x1F08, 0x1F0F, -8, 1 }, { 0x1F18, 0x1F1D, -8, 1 }, { 0x1F28, 0x1F2F, -8, 1 },
+            { 0x1F38, 0x1F3F, -8, 1 }, { 0x1F48, 0x1F4D, -8, 1 }, { 0x1F59, 0x1F5F, -8, 2 },
+            { 0x1F68, 0x1F6F, -8, 1 }, { 0x1F88, 0x1F8F, -8, 1 }, { 0x1F98, 0x1F9F, -8, 1 },
+            { 0x1FA8, 0x1FAF, -8, 1 }, { 0x1FB8, 0x1FB9, -8, 1 }, { 0x1FBA, 0x1FBB, -0x004A, 1 },
+            { 0x1FBC, 0x1FBC, -9, 1 }, { 0x1FBE, 0x1FBE, -0x1C05, 1 }, { 0x1FC8, 0x1FCB, -0x0056, 1 },
+            { 0x1FCC, 0x1FCC, -9, 1 }, { 0x1FD8, 0x1FD9, -8, 1 }, { 0x1FDA, 0x1FDB, -0x0064, 1 },
+            { 0x1FE8, 0x1FE9, -8, 1 }, { 0x1FEA, 0x1FEB, -0x0070, 1 }, { 0x1FEC, 0x1FEC, -7, 1 },
+            { 0x1FF8, 0x1FF9, -0x0080, 1 }, { 0x1FFA, 0x1FFB, -0x007E, 1 }, { 0x1FFC, 0x1FFC, -9, 1 },
+            // Letterlike symbols, number forms, enclosed letters
+            { 0x2126, 0x2126, -0x1D5D, 1 }, { 0x212A, 0x212A, -0x20BF, 1 }, { 0x212B, 0x212B, -0x2046, 1 },
+            { 0x2132, 0x2132, 0x001C, 1 }, { 0x2160, 0x216F, 0x0010, 1 }, { 0x2183, 0x2183, 1, 1 },
+            { 0x24B6, 0x24CF, 0x001A, 1 },
+            // Glagolitic, Latin Extended-C, Coptic
+            { 0x2C00, 0x2C2F, 0x0030, 1 }, { 0x2C60, 0x2C60, 1, 1 }, { 0x2C62, 0x2C62, -0x29F7, 1 },
+            { 0x2C63, 0x2C63, -0x0EE6, 1 }, { 0x2C64, 0x2C64, -0x29E7, 1 }, { 0x2C67, 0x2C6B, 1, 2 },
+            { 0x2C6D, 0x2C6D, -0x2A1C, 1 }, { 0x2C6E, 0x2C6E, -0x29FD, 1 }, { 0x2C6F, 0x2C6F, -0x2A1F, 1 },
+            { 0x2C70, 0x2C70, -0x2A1E, 1 }, { 0x2C72, 0x2C72, 1, 1 }, { 0x2C75, 0x2C75, 1, 1 },
+            { 0x2C7E, 0x2C7F, -0x2A3F, 1 }, { 0x2C80, 0x2CE2, 1, 2 }, { 0x2CEB, 0x2CED, 1, 2 },
+            { 0x2CF2, 0x2CF2, 1, 1 },
+            // Cyrillic Extended-B, Latin Extended-D
+            { 0xA640, 0xA66C, 1, 2 }, { 0xA680, 0xA69A, 1, 2 }, { 0xA722, 0xA72E, 1, 2 },
+            { 0xA732, 0xA76E, 1, 2 }, { 0xA779, 0xA77B, 1, 2 }, { 0xA77D, 0xA77D, -0x8A04, 1 },
+            { 0xA77E, 0xA786, 1, 2 }, { 0xA78B, 0xA78B, 1, 1 }, { 0xA78D, 0xA78D, -0xA528, 1 },
+            { 0xA790, 0xA792, 1, 2 }, { 0xA796, 0xA7A8, 1, 2 }, { 0xA7AA, 0xA7AA, -0xA544, 1 },
+            { 0xA7AB, 0xA7AB, -0xA54F, 1 }, { 0xA7AC, 0xA7AC, -0xA54B, 1 }, { 0xA7AD, 0xA7AD, -0xA541, 1 },
+            { 0xA7AE, 0xA7AE, -0xA544, 1 }, { 0xA7B0, 0xA7B0, -0xA512, 1 }, { 0xA7B1, 0xA7B1, -0xA52A, 1 },
+            { 0xA7B2, 0xA7B2, -0xA515, 1 }, { 0xA7B3, 0xA7B3, 0x03A0, 1 }, { 0xA7B4, 0xA7C2, 1, 2 },
+            { 0xA7C4, 0xA7C4, -0x0030, 1 }, { 0xA7C5, 0xA7C5, -0xA543, 1 }, { 0xA7C6, 0xA7C6, -0x8A38, 1 },
+            { 0xA7C7, 0xA7C9, 1, 2 }, { 0xA7D0, 0xA7D0, 1, 1 }, { 0xA7D6, 0xA7D8, 1, 2 },
+            { 0xA7F5, 0xA7F5, 1, 1 },
+            // Cherokee supplement
+            { 0xAB70, 0xABBF, -0x97D0, 1 },
+            // Fullwidth forms
+            { 0xFF21, 0xFF3A, 0x0020, 1 },
+        };
+
+        // Latin and Greek letters whose canonical decomposition is a base
+        // letter plus combining marks, plus the stroked letters (ø, đ, ł, ...)
+        // that have none. Cyrillic is left alone: й and ё are letters of
+        // their own there.
+        constexpr StripRange kStripRanges[] = {
+            { 0x00C0, 0x00C5, L'a' }, { 0x00C7, 0x00C7, L'c' }, { 0x00C8, 0x00CB, L'e' },
+            { 0x00CC, 0x00CF, L'i' }, { 0x00D1, 0x00D1, L'n' }, { 0x00D2, 0x00D6, L'o' },
+            { 0x00D8, 0x00D8, L'o' }, { 0x00D9, 0x00DC, L'u' }, { 0x00DD, 0x00DD, L'y' },
+            { 0x00E0, 0x00E5, L'a' }, { 0x00E7, 0x00E7, L'c' }, { 0x00E8, 0x00EB, L'e' },
+            { 0x00EC, 0x00EF, L'i' }, { 0x00F1, 0x00F1, L'n' }, { 0x00F2, 0x00F6, L'o' },
+            { 0x00F8, 0x00F8, L'o' }, { 0x00F9, 0x00FC, L'u' }, { 0x00FD, 0x00FD, L'y' },
+            { 0x00FF, 0x00FF, L'y' }, { 0x0100, 0x0105, L'a' }, { 0x0106, 0x010D, L'c' },
+            { 0x010E, 0x0111, L'd' }, { 0x0112, 0x011B, L'e' }, { 0x011C, 0x0123, L'g' },
+            { 0x0124, 0x0127, L'h' }, { 0x0128, 0x0131, L'i' }, { 0x0134, 0x0135, L'j' },
+            { 0x0136, 0x0137, L'k' }, { 0x0139, 0x013E, L'l' }, { 0x0141, 0x0142, L'l' },
+            { 0x0143, 0x0148, L'n' }, { 0x014C, 0x0151, L'o' }, { 0x0154, 0x0159, L'r' },
+            { 0x015A, 0x0161, L's' }, { 0x0162, 0x0167, L't' }, { 0x0168, 0x0173, L'u' },
+            { 0x0174, 0x0175, L'w' }, { 0x0176, 0x0178, L'y' }, { 0x0179, 0x017E, L'z' },
+            { 0x01A0, 0x01A1, L'o' }, { 0x01AF, 0x01B0, L'u' }, { 0x01CD, 0x01CE, L'a' },
+            { 0x01CF, 0x01D0, L'i' }, { 0x01D1, 0x01D2, L'o' }, { 0x01D3, 0x01DC, L'u' },
+            { 0x01DE, 0x01E1, L'a' }, { 0x01E2, 0x01E3, 0x00E6 }, { 0x01E6, 0x01E7, L'g' },
+            { 0x01E8, 0x01E9, L'k' }, { 0x01EA, 0x01ED, L'o' }, { 0x01EE, 0x01EF, 0x0292 },
+            { 0x01F0, 0x01F0, L'j' }, { 0x01F4, 0x01F5, L'g' }, { 0x01F8, 0x01F9, L'n' },
+            { 0x01FA, 0x01FB, L'a' }, { 0x01FC, 0x01FD, 0x00E6 }, { 0x01FE, 0x01FF, L'o' },
+            { 0x0200, 0x0203, L'a' }, { 0x0204, 0x0207, L'e' }, { 0x0208, 0x020B, L'i' },
+            { 0x020C, 0x020F, L'o' }, { 0x0210, 0x0213, L'r' }, { 0x0214, 0x0217, L'u' },
+            { 0x0218, 0x0219, L's' }, { 0x021A, 0x021B, L't' }, { 0x021E, 0x021F, L'h' },
+            { 0x0226, 0x0227, L'a' }, { 0x0228, 0x0229, L'e' }, { 0x022A, 0x0231, L'o' },
+            { 0x0232, 0x0233, L'y' }, { 0x0386, 0x0386, 0x03B1 }, { 0x0388, 0x0388, 0x03B5 },
+            { 0x0389, 0x0389, 0x03B7 }, { 0x038A, 0x038A, 0x03B9 }, { 0x038C, 0x038C, 0x03BF },
+            { 0x038E, 0x038E, 0x03C5 }, { 0x038F, 0x038F, 0x03C9 }, { 0x0390, 0x0390, 0x03B9 },
+            { 0x03AA, 0x03AA, 0x03B9 }, { 0x03AB, 0x03AB, 0x03C5 }, { 0x03AC, 0x03AC, 0x03B1 },
+            { 0x03AD, 0x03AD, 0x03B5 }, { 0x03AE, 0x03AE, 0x03B7 }, { 0x03AF, 0x03AF, 0x03B9 },
+            { 0x03B0, 0x03B0, 0x03C5 }, { 0x03CA, 0x03CA, 0x03B9 }, { 0x03CB, 0x03CB, 0x03C5 },
+            { 0x03CC, 0x03CC, 0x03BF }, { 0x03CD, 0x03CD, 0x03C5 }, { 0x03CE, 0x03CE, 0x03C9 },
+            { 0x03D3, 0x03D4, 0x03D2 }, { 0x1E00, 0x1E01, L'a' }, { 0x1E02, 0x1E07, L'b' },
+            { 0x1E08, 0x1E09, L'c' }, { 0x1E0A, 0x1E13, L'd' }, { 0x1E14, 0x1E1D, L'e' },
+            { 0x1E1E, 0x1E1F, L'f' }, { 0x1E20, 0x1E21, L'g' }, { 0x1E22, 0x1E2B, L'h' },
+            { 0x1E2C, 0x1E2F, L'i' }, { 0x1E30, 0x1E35, L'k' }, { 0x1E36, 0x1E3D, L'l' },
+            { 0x1E3E, 0x1E43, L'm' }, { 0x1E44, 0x1E4B, L'n' }, { 0x1E4C, 0x1E53, L'o' },
+            { 0x1E54, 0x1E57, L'p' }, { 0x1E58, 0x1E5F, L'r' }, { 0x1E60, 0x1E69, L's' },
+            { 0x1E6A, 0x1E71, L't' }, { 0x1E72, 0x1E7B, L'u' }, { 0x1E7C, 0x1E7F, L'v' },
+            { 0x1E80, 0x1E89, L'w' }, { 0x1E8A, 0x1E8D, L'x' }, { 0x1E8E, 0x1E8F, L'y' },
+            { 0x1E90, 0x1E95, L'z' }, { 0x1E96, 0x1E96, L'h' }, { 0x1E97, 0x1E97, L't' },
+            { 0x1E98, 0x1E98, L'w' }, { 0x1E99, 0x1E99, L'y' }, { 0x1E9B, 0x1E9B, 0x017F },
+            { 0x1EA0, 0x1EB7, L'a' }, { 0x1EB8, 0x1EC7, L'e' }, { 0x1EC8, 0x1ECB, L'i' },
+            { 0x1ECC, 0x1EE3, L'o' }, { 0x1EE4, 0x1EF1, L'u' }, { 0x1EF2, 0x1EF9, L'y' },
+            { 0x1F00, 0x1F0F, 0x03B1 }, { 0x1F10, 0x1F15, 0x03B5 }, { 0x1F18, 0x1F1D, 0x03B5 },
+            { 0x1F20, 0x1F2F, 0x03B7 }, { 0x1F30, 0x1F3F, 0x03B9 }, { 0x1F40, 0x1F45, 0x03BF },
+            { 0x1F48, 0x1F4D, 0x03BF }, { 0x1F50, 0x1F57, 0x03C5 }, { 0x1F59, 0x1F59, 0x03C5 },
+            { 0x1F5B, 0x1F5B, 0x03C5 }, { 0x1F5D, 0x1F5D, 0x03C5 }, { 0x1F5F, 0x1F5F, 0x03C5 },
+            { 0x1F60, 0x1F6F, 0x03C9 }, { 0x1F70, 0x1F71, 0x03B1 }, { 0x1F72, 0x1F73, 0x03B5 },
+            { 0x1F74, 0x1F75, 0x03B7 }, { 0x1F76, 0x1F77, 0x03B9 }, { 0x1F78, 0x1F79, 0x03BF },
+            { 0x1F7A, 0x1F7B, 0x03C5 }, { 0x1F7C, 0x1F7D, 0x03C9 }, { 0x1F80, 0x1F8F, 0x03B1 },
+            { 0x1F90, 0x1F9F, 0x03B7 }, { 0x1FA0, 0x1FAF, 0x03C9 }, { 0x1FB0, 0x1FB4, 0x03B1 },
+            { 0x1FB6, 0x1FBC, 0x03B1 }, { 0x1FC2, 0x1FC4, 0x03B7 }, { 0x1FC6, 0x1FC7, 0x03B7 },
+            { 0x1FC8, 0x1FC9, 0x03B5 }, { 0x1FCA, 0x1FCC, 0x03B7 }, { 0x1FD0, 0x1FD3, 0x03B9 },
+            { 0x1FD6, 0x1FDB, 0x03B9 }, { 0x1FE0, 0x1FE3, 0x03C5 }, { 0x1FE4, 0x1FE5, 0x03C1 },
+            { 0x1FE6, 0x1FEB, 0x03C5 }, { 0x1FEC, 0x1FEC, 0x03C1 }, { 0x1FF2, 0x1FF4, 0x03C9 },
+            { 0x1FF6, 0x1FF7, 0x03C9 }, { 0x1FF8, 0x1FF9, 0x03BF }, { 0x1FFA, 0x1FFC, 0x03C9 },
+        };
+
+        template <size_t Blocks>
+        struct Table {
+            uint8_t index[256];            // high byte -> block
+            uint16_t delta[Blocks][256];   // low byte -> (folded - code) mod 2^16
+        };
+
+        constexpr void MarkBlocks(bool (&used)[256], bool strip) {
+            for (const FoldRange& range : kFoldRanges) {
+                for (unsigned block = range.first >> 8; block <= (range.last >> 8); ++block) {
+                    used[block] = true;
+                }
+            }
+            if (strip) {
+                for (const StripRange& range : kStripRanges) {
+                    for (unsigned block = range.first >> 8; block <= (range.last >> 8); ++block) {
+                        used[block] = true;
+                    }
+                }
+            }
+        }
+
+        constexpr size_t CountBlocks(bool strip) {
+            bool used[256] = {};
+            MarkBlocks(used, strip);
+            size_t count = 1; // the shared zero block
+            for (bool u : used) {
+                count += u ? 1 : 0;
+            }
+            return count;
+        }
+
+        template <size_t Blocks>
+        constexpr unsigned Lookup(const Table<Blocks>& table, unsigned code) {
+            return (code + table.delta[table.index[code >> 8]][code & 0xFF]) & 0xFFFF;
+        }
+
+        template <size_t Blocks>
+        constexpr void Set(Table<Blocks>& table, unsigned code, unsigned folded) {
+            table.delta[table.index[code >> 8]][code & 0xFF] = static_cast<uint16_t>(folded - code);
+        }
+
+        template <bool Strip>
+        constexpr Table<CountBlocks(Strip)> BuildTable() {
+            Table<CountBlocks(Strip)> table{};
+
+            bool used[256] = {};
+            MarkBlocks(used, Strip);
+            uint8_t next = 1;
+            for (unsigned block = 0; block < 256; ++block) {
+                table.index[block] = used[block] ? next++ : 0;
+            }
+
+            for (const FoldRange& range : kFoldRanges) {
+                for (unsigned code = range.first; code <= range.last; code += range.stride) {
+                    Set(table, code, static_cast<unsigned>(static_cast<int32_t>(code) + range.delta));
+                }
+            }
+
+            if (Strip) {
+                for (const StripRange& range : kStripRanges) {
+                    for (unsigned code = range.first; code <= range.last; ++code) {
+                        Set(table, code, range.base);
+                    }
+                }
+                // Letters that only fold into a strippable one (Å -> å -> a)
+                for (const FoldRange& range : kFoldRanges) {
+                    for (unsigned code = range.first; code <= range.last; code += range.stride) {
+                        Set(table, code, Lookup(table, Lookup(table, code)));
+                    }
+                }
+            }
+            return table;
+        }
+
+        inline constexpr auto kCaseTable = BuildTable<false>();
+        inline constexpr auto kBaseTable = BuildTable<true>();
+
+        template <size_t Blocks>
+        inline wchar_t Apply(const Table<Blocks>& table, wchar_t c) {
+            const auto code = static_cast<uint32_t>(c);
+            if (code > 0xFFFF) return c;
+            return static_cast<wchar_t>(Lookup(table, code));
+        }
+    }
+
+    // Case folding only
+    inline wchar_t FoldCase(wchar_t c) { return detail::Apply(detail::kCaseTable, c); }
+
+    // Case folding and diacritic stripping
+    inline wchar_t FoldToBase(wchar_t c) { return detail::Apply(detail::kBaseTable, c); }
+
+    inline wchar_t Fold(wchar_t c, bool stripDiacritics) {
+        return stripDiacritics ? FoldToBase(c) : FoldCase(c);
+    }
+
+    // Folds `length` characters in place
+    void Fold(wchar_t* text, size_t length, bool stripDiacritics);
+    void Fold(std::wstring& text, bool stripDiacritics);
+    std::wstring Folded(const std::wstring& text, bool stripDiacritics);
+}
@@ -0,0 +1,127 @@
+#include "CharMask.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CHARMASK_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHARMASK_SSE2 1
+#endif
+
+namespace CharMask {
+
+unsigned BitFor(wchar_t c) {
+    const uint32_t code = static_cast<uint32_t>(c);
+    if (code >= L'a' && code <= L'z') return code - L'a';
+    if (code >= L'A' && code <= L'Z') return code - L'A';
+    if (code >= L'0' && code <= L'9') return 26 + (code - L'0');
+    if (code == L' ') return 36;
+    if (code < 0x80) return 37 + code % 11;
+    return 48 + ((code * 2654435761u) >> 28);
+}
+
+uint64_t Compute(const wchar_t* text, size_t length) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < length; ++i) {
+        mask |= uint64_t(1) << BitFor(text[i]);
+    }
+    return mask;
+}
+
+} // namespace CharMask
+
+CharMaskPrefilter::CharMaskPrefilter(const std::wstring& foldedQuery, MissTolerance mayMatchWithMissing)
+    : m_queryMask(0)
+    , m_fatalMisses(1)
+    , m_bits{}
+    , m_weights{}
+    , m_bitCount(0) {
+
+    for (wchar_t c : foldedQuery) {
+        const unsigned bit = CharMask::BitFor(c);
+        size_t slot = 0;
+        while (slot < m_bitCount && m_bits[slot] != bit) {
+            ++slot;
+        }
+        if (slot == m_bitCount) {
+            m_bits[m_bitCount++] = static_cast<uint8_t>(bit);
+            m_queryMask |= uint64_t(1) << bit;
+        }
+        if (m_weights[slot] < 255) {
+            ++m_weights[slot];
+        }
+    }
+
+    // Find the first miss count whose best case stays at or under the threshold
+    const size_t m = foldedQuery.size();
+    m_fatalMisses = m + 1;
+    for (size_t k = 1; k <= m; ++k) {
+        if (!mayMatchWithMissing(m, k)) {
+            m_fatalMisses = k;
+            break;
+        }
+    }
+}
+
+size_t CharMaskPrefilter::MissingCount(uint64_t windowMask) const {
+    size_t count = 0;
+    for (size_t slot = 0; slot < m_bitCount; ++slot) {
+        if (!(windowMask & (uint64_t(1) << m_bits[slot]))) {
+            count += m_weights[slot];
+        }
+    }
+    return count;
+}
+
+bool CharMaskPrefilter::MayMatch(uint64_t windowMask) const {
+    if ((windowMask & m_queryMask) == m_queryMask) {
+        return true;
+    }
+    return m_fatalMisses > 1 && MissingCount(windowMask) < m_fatalMisses;
+}
+
+void CharMaskPrefilter::Filter(const uint64_t* masks, size_t count, std::vector<size_t>& survivors) const {
+    size_t i = 0;
+
+    // Masks with every query bit set always survive; the rest only need the
+    // scalar miss count when the query tolerates misses at all.
+    auto partial = [&](size_t index) {
+        if (m_fatalMisses > 1 && MissingCount(masks[index]) < m_fatalMisses) {
+            survivors.push_back(index);
+        }
+    };
+
+#if defined(CHARMASK_AVX2)
+    const __m256i query = _mm256_set1_epi64x(static_cast<long long>(m_queryMask));
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i));
+        __m256i hit = _mm256_cmpeq_epi64(_mm256_and_si256(v, query), query);
+        int lanes = _mm256_movemask_pd(_mm256_castsi256_pd(hit));
+        for (int lane = 0; lane < 4; ++lane) {
+            if (lanes & (1 << lane)) {
+                survivors.push_back(i + lane);
+            } else {
+                partial(i + lane);
+            }
+        }
+    }
+#elif defined(CHARMASK_SSE2)
+    // SSE2 has no 64-bit compare: compare 32-bit halves, both must match
+    const __m128i query = _mm_set1_epi64x(static_cast<long long>(m_queryMask));
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+        __m128i hit = _mm_cmpeq_epi32(_mm_and_si128(v, query), query);
+        int halves = _mm_movemask_ps(_mm_castsi128_ps(hit));
+        if ((halves & 0x3) == 0x3) survivors.push_back(i); else partial(i);
+        if ((halves & 0xC) == 0xC) survivors.push_back(i + 1); else partial(i + 1);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if ((masks[i] & m_queryMask) == m_queryMask) {
+            survivors.push_back(i);
+        } else {
+            partial(i);
+        }
+    }
+}
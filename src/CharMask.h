@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 64-bit character-presence masks for cheap candidate rejection.
+// Bits 0-25 are the letters a-z, 26-35 the digits, 36 the space. Other ASCII
+// punctuation shares 11 hashed buckets (37-47) and every other code point
+// 16 hashed buckets (48-63). A clear bit proves the character is absent; a
+// set bit may be a bucket collision.
+namespace CharMask {
+    unsigned BitFor(wchar_t c);
+    uint64_t Compute(const wchar_t* text, size_t length);
+    inline uint64_t Compute(const std::wstring& text) { return Compute(text.data(), text.size()); }
+}
+
+// Rejects windows that cannot reach the match threshold because too many
+// query characters are missing from them. With one or two typed characters
+// any miss is fatal; longer queries tolerate a few misses (the fuzzy and
+// position components still reward near-misses), so the number of missing
+// query characters is weighed against the scorer's best case, as reported by
+// BasicSearchScorer::MayMatchWithMissing for the scoring policy in use.
+class CharMaskPrefilter {
+public:
+    // Whether a window lacking `missing` of `queryLength` query characters may still match
+    using MissTolerance = bool (*)(size_t queryLength, size_t missing);
+
+    CharMaskPrefilter(const std::wstring& foldedQuery, MissTolerance mayMatchWithMissing);
+
+    // True if a window with this mask may still score above the threshold.
+    bool MayMatch(uint64_t windowMask) const;
+
+    // Appends the indices of all masks that pass MayMatch(). Uses AVX2 or
+    // SSE2 to test several masks per instruction where available.
+    void Filter(const uint64_t* masks, size_t count, std::vector<size_t>& survivors) const;
+
+    // Smallest number of missing query characters that is always fatal.
+    size_t FatalMisses() const { return m_fatalMisses; }
+
+private:
+    size_t MissingCount(uint64_t windowMask) const;
+
+    uint64_t m_queryMask;
+    size_t m_fatalMisses;
+    uint8_t m_bits[64];    // Distinct bits of the query mask
+    uint8_t m_weights[64]; // Query characters per entry of m_bits
+    size_t m_bitCount;
+};
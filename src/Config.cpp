@@ -4,7 +4,7 @@
 #include <string>
 #include <sstream>
 #include <algorithm>
-#include <cwctype>
+#include "CaseFold.h"
 
 // Helper function to trim from both ends
 static inline std::wstring trim(const std::wstring& s) {
@@ -55,6 +55,18 @@ namespace Config {
     COLORREF BORDER_COLOR = RGB(80, 80, 80);
     std::vector<std::wstring> EXCLUDED_PROCESSES;
     std::vector<std::wstring> EXCLUDED_TITLES;
+    bool VERIFY_PREFILTER = false;
+    int PARALLEL_THRESHOLD = 4096;
+    int SEARCH_THREADS = 0;
+    bool STRIP_DIACRITICS = true;
+    int RESULT_CACHE_SIZE = 16;
+    ScoringPreset SCORING_PRESET = ScoringPreset::Balanced;
+    bool FRECENCY_ENABLED = true;
+    int FRECENCY_HALF_LIFE_HOURS = 168;
+    std::wstring FRECENCY_FILE;
+    std::wstring TRACE_FILE;
+    int RECONCILE_SECONDS = 30;
+    int MESSAGE_TIMEOUT_MS = 100;
 
     void LoadConfig() {
         wchar_t exePath[MAX_PATH];
@@ -87,18 +99,46 @@ namespace Config {
         GetPrivateProfileStringW(L"Appearance", L"BorderColor", L"80,80,80", colorStr, 50, configPath.c_str());
         BORDER_COLOR = parseColor(colorStr, RGB(80, 80, 80));
 
-        // Window Filters
+        // Search settings
+        VERIFY_PREFILTER = GetPrivateProfileIntW(L"Search", L"VerifyPrefilter", 0, configPath.c_str()) != 0;
+        PARALLEL_THRESHOLD = GetPrivateProfileIntW(L"Search", L"ParallelThreshold", 4096, configPath.c_str());
+        SEARCH_THREADS = GetPrivateProfileIntW(L"Search", L"SearchThreads", 0, configPath.c_str());
+        STRIP_DIACRITICS = GetPrivateProfileIntW(L"Search", L"StripDiacritics", 1, configPath.c_str()) != 0;
+        RESULT_CACHE_SIZE = GetPrivateProfileIntW(L"Search", L"ResultCacheSize", 16, configPath.c_str());
+        wchar_t presetStr[32];
+        GetPrivateProfileStringW(L"Search", L"ScoringPreset", L"balanced", presetStr, 32, configPath.c_str());
+        if (!ParseScoringPreset(CaseFold::Folded(trim(presetStr), false), SCORING_PRESET)) {
+            SCORING_PRESET = ScoringPreset::Balanced;
+        }
+
+        // Frecency settings
+        FRECENCY_ENABLED = GetPrivateProfileIntW(L"Frecency", L"Enabled", 1, configPath.c_str()) != 0;
+        FRECENCY_HALF_LIFE_HOURS = GetPrivateProfileIntW(L"Frecency", L"HalfLifeHours", 168, configPath.c_str());
+        wchar_t frecencyFile[MAX_PATH];
+        GetPrivateProfileStringW(L"Frecency", L"File", L"", frecencyFile, MAX_PATH, configPath.c_str());
+        FRECENCY_FILE = frecencyFile[0] ? frecencyFile : std::wstring(exePath).substr(0, pos) + L"\\frecency.dat";
+
+        // Trace settings
+        wchar_t traceFile[MAX_PATH];
+        GetPrivateProfileStringW(L"Trace", L"File", L"", traceFile, MAX_PATH, configPath.c_str());
+        TRACE_FILE = trim(traceFile);
+
+        // Updater settings
+        RECONCILE_SECONDS = GetPrivateProfileIntW(L"Updater", L"ReconcileSeconds", 30, configPath.c_str());
+        MESSAGE_TIMEOUT_MS = GetPrivateProfileIntW(L"Updater", L"MessageTimeoutMs", 100, configPath.c_str());
+
+        // Window Filters (folded once here, matched against folded names)
         wchar_t buffer[2048];
         GetPrivateProfileStringW(L"WindowFilters", L"ExcludeProcessNames", L"", buffer, 2048, configPath.c_str());
         EXCLUDED_PROCESSES = split(buffer, L',');
         for (auto& proc : EXCLUDED_PROCESSES) {
-            std::transform(proc.begin(), proc.end(), proc.begin(), ::towlower);
+            CaseFold::Fold(proc, STRIP_DIACRITICS);
         }
 
         GetPrivateProfileStringW(L"WindowFilters", L"ExcludeTitles", L"", buffer, 2048, configPath.c_str());
         EXCLUDED_TITLES = split(buffer, L',');
         for (auto& title : EXCLUDED_TITLES) {
-            std::transform(title.begin(), title.end(), title.begin(), ::towlower);
+            CaseFold::Fold(title, STRIP_DIACRITICS);
         }
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <windows.h>
 #include <string>
+#include "SearchScorer.h"
 #include <vector>
 
 // Custom message for keyboard events from the hook
@@ -31,5 +32,25 @@ namespace Config {
     extern std::vector<std::wstring> EXCLUDED_PROCESSES;
     extern std::vector<std::wstring> EXCLUDED_TITLES;
 
+    // Search
+    extern bool VERIFY_PREFILTER; // Also score prefilter rejects and report misses
+    extern int PARALLEL_THRESHOLD; // Candidates before scoring goes multi-threaded, 0 = never
+    extern int SEARCH_THREADS;     // Threads for parallel scoring, 0 = all cores
+    extern bool STRIP_DIACRITICS;  // Match "é" with "e" (and "É")
+    extern int RESULT_CACHE_SIZE;  // Queries whose results are cached per snapshot, 0 = off
+    extern ScoringPreset SCORING_PRESET; // balanced, title-only or process-first
+
+    // Frecency settings
+    extern bool FRECENCY_ENABLED;       // Rank and preselect by activation history
+    extern int FRECENCY_HALF_LIFE_HOURS;
+    extern std::wstring FRECENCY_FILE;  // Defaults to frecency.dat next to the exe
+
+    // Trace settings
+    extern std::wstring TRACE_FILE; // Sessions are appended here for replay; empty = off
+
+    // Updater settings
+    extern int RECONCILE_SECONDS; // Full enumerations between window events, to catch missed ones
+    extern int MESSAGE_TIMEOUT_MS; // How long a window may take to answer before it gets a placeholder
+
     void LoadConfig(); // Function to load all settings
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "EditDistance.h"
+#include <algorithm>
+#include <array>
+
+EditDistancePattern::EditDistancePattern(const std::wstring& pattern, std::pmr::memory_resource* memory)
+    : m_length(pattern.size())
+    , m_blocks((pattern.size() + 63) / 64)
+    , m_directMasks(memory)
+    , m_extraChars(memory)
+    , m_extraMasks(memory) {
+
+    m_directMasks.assign(m_blocks * kDirectChars, 0);
+
+    for (wchar_t c : pattern) {
+        if (static_cast<size_t>(c) >= kDirectChars) {
+            m_extraChars.push_back(c);
+        }
+    }
+    std::sort(m_extraChars.begin(), m_extraChars.end());
+    m_extraChars.erase(std::unique(m_extraChars.begin(), m_extraChars.end()), m_extraChars.end());
+    m_extraMasks.assign(m_extraChars.size() * m_blocks, 0);
+
+    for (size_t i = 0; i < m_length; ++i) {
+        const wchar_t c = pattern[i];
+        const size_t block = i / 64;
+        const uint64_t bit = uint64_t(1) << (i % 64);
+        if (static_cast<size_t>(c) < kDirectChars) {
+            m_directMasks[block * kDirectChars + static_cast<size_t>(c)] |= bit;
+        } else {
+            size_t slot = std::lower_bound(m_extraChars.begin(), m_extraChars.end(), c) - m_extraChars.begin();
+            m_extraMasks[slot * m_blocks + block] |= bit;
+        }
+    }
+}
+
+uint64_t EditDistancePattern::Mask(size_t block, wchar_t c) const {
+    if (static_cast<size_t>(c) < kDirectChars) {
+        return m_directMasks[block * kDirectChars + static_cast<size_t>(c)];
+    }
+    auto it = std::lower_bound(m_extraChars.begin(), m_extraChars.end(), c);
+    if (it == m_extraChars.end() || *it != c) {
+        return 0;
+    }
+    return m_extraMasks[static_cast<size_t>(it - m_extraChars.begin()) * m_blocks + block];
+}
+
+size_t EditDistancePattern::Distance(const wchar_t* text, size_t length) const {
+    if (m_length == 0) return length;
+    if (length == 0) return m_length;
+    return m_blocks == 1 ? DistanceSingleWord(text, length) : DistanceMultiWord(text, length);
+}
+
+size_t EditDistancePattern::DistanceSingleWord(const wchar_t* text, size_t length) const {
+    // Vertical deltas of the current DP column: +1 (Pv) or -1 (Mv) per row.
+    // The first column is 0..m, i.e. all +1.
+    const uint64_t last = uint64_t(1) << (m_length - 1);
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+    size_t score = m_length;
+
+    for (size_t j = 0; j < length; ++j) {
+        const uint64_t eq = Mask(0, text[j]);
+        const uint64_t xv = eq | mv;
+        const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last) {
+            ++score;
+        } else if (mh & last) {
+            --score;
+        }
+
+        // Row 0 of the table is 0..n, so the horizontal delta entering the
+        // column from above is always +1.
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+
+    return score;
+}
+
+size_t EditDistancePattern::DistanceMultiWord(const wchar_t* text, size_t length) const {
+    // Runs concurrently on one pattern, so the columns live on the stack;
+    // only queries beyond 4096 characters spill to the heap
+    std::array<std::byte, 1024> stack;
+    std::pmr::monotonic_buffer_resource columns(stack.data(), stack.size());
+    std::pmr::vector<uint64_t> pv(m_blocks, ~uint64_t(0), &columns);
+    std::pmr::vector<uint64_t> mv(m_blocks, 0, &columns);
+    const uint64_t last = uint64_t(1) << ((m_length - 1) % 64);
+    size_t score = m_length;
+
+    for (size_t j = 0; j < length; ++j) {
+        const wchar_t c = text[j];
+        int carry = 1; // Horizontal delta entering the lowest block
+
+        for (size_t b = 0; b < m_blocks; ++b) {
+            uint64_t eq = Mask(b, c);
+            const uint64_t xv = eq | mv[b];
+            if (carry < 0) {
+                eq |= 1;
+            }
+            const uint64_t xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+            uint64_t ph = mv[b] | ~(xh | pv[b]);
+            uint64_t mh = pv[b] & xh;
+
+            const uint64_t top = (b + 1 == m_blocks) ? last : (uint64_t(1) << 63);
+            int carryOut = (ph & top) ? 1 : ((mh & top) ? -1 : 0);
+
+            ph <<= 1;
+            mh <<= 1;
+            if (carry > 0) {
+                ph |= 1;
+            } else if (carry < 0) {
+                mh |= 1;
+            }
+            pv[b] = mh | ~(xv | ph);
+            mv[b] = ph & xv;
+            carry = carryOut;
+        }
+
+        if (carry > 0) {
+            ++score;
+        } else if (carry < 0) {
+            --score;
+        }
+    }
+
+    return score;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Bit-parallel Levenshtein distance (Myers 1999, Hyyro 2001).
+// The pattern is compiled once per query; every Distance() call then costs
+// one pass over the text with a handful of word operations per character.
+// Patterns up to 64 characters fit in a single machine word, longer ones
+// fall back to a block-based variant that carries deltas between words.
+// The masks live in `memory`, typically the scratch arena of a filter pass.
+class EditDistancePattern {
+public:
+    explicit EditDistancePattern(const std::wstring& pattern,
+                                 std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Same result as the classic O(m*n) dynamic programming table.
+    size_t Distance(const wchar_t* text, size_t length) const;
+    size_t Distance(const std::wstring& text) const { return Distance(text.data(), text.size()); }
+
+    size_t Length() const { return m_length; }
+    size_t Blocks() const { return m_blocks; }
+
+    // Bit i of block b is set where pattern[b * 64 + i] == c. Exposed so that
+    // fused scanners can step the single-word recurrence themselves.
+    uint64_t Mask(size_t block, wchar_t c) const;
+
+private:
+    static constexpr size_t kDirectChars = 256;
+
+    size_t DistanceSingleWord(const wchar_t* text, size_t length) const;
+    size_t DistanceMultiWord(const wchar_t* text, size_t length) const;
+
+    size_t m_length;
+    size_t m_blocks;
+
+    // Match masks ("Peq") per block: a direct table for Latin-1 and a
+    // sorted list for the few other characters a query can contain.
+    std::pmr::vector<uint64_t> m_directMasks; // m_blocks * kDirectChars
+    std::pmr::vector<wchar_t> m_extraChars;   // sorted, unique
+    std::pmr::vector<uint64_t> m_extraMasks;  // m_extraChars.size() * m_blocks
+};
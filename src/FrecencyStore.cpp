@@ -0,0 +1,258 @@
+#include "FrecencyStore.h"
+#include "CaseFold.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+    constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+    uint64_t HashUnits(uint64_t hash, const wchar_t* text, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ static_cast<uint32_t>(text[i])) * kFnvPrime;
+        }
+        return hash;
+    }
+
+    // splitmix64 finalizer; never returns the empty-slot key 0
+    uint64_t Finish(uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xBF58476D1CE4E5B9ull;
+        hash ^= hash >> 27;
+        hash *= 0x94D049BB133111EBull;
+        hash ^= hash >> 31;
+        return hash ? hash : 1;
+    }
+
+    // Punctuation, symbols and dingbats that decorate titles ("● ", "* ")
+    bool IsDecoration(wchar_t c) {
+        const auto code = static_cast<uint32_t>(c);
+        if (code < 0x80) {
+            return !((c >= L'a' && c <= L'z') || (c >= L'0' && c <= L'9') || c == L'#');
+        }
+        return code >= 0x2000 && code <= 0x2BFF;
+    }
+
+    // Folds the title, turns every run of digits into one '#' (unread
+    // counts, progress) and trims decorations off both ends
+    std::wstring NormalizeTitle(const std::wstring& title) {
+        std::wstring folded = CaseFold::Folded(title, true);
+        std::wstring normalized;
+        normalized.reserve(folded.size());
+        for (size_t i = 0; i < folded.size(); ++i) {
+            const wchar_t c = folded[i];
+            if (c >= L'0' && c <= L'9') {
+                if (normalized.empty() || normalized.back() != L'#') {
+                    normalized.push_back(L'#');
+                }
+            } else if (c == L' ' && !normalized.empty() && normalized.back() == L' ') {
+                continue;
+            } else {
+                normalized.push_back(c);
+            }
+        }
+
+        size_t begin = 0;
+        size_t end = normalized.size();
+        while (begin < end && IsDecoration(normalized[begin])) ++begin;
+        while (end > begin && IsDecoration(normalized[end - 1])) --end;
+        return normalized.substr(begin, end - begin);
+    }
+}
+
+FrecencyStore::FrecencyStore(uint32_t capacity)
+    : m_capacity(16) {
+    while (m_capacity < capacity) {
+        m_capacity <<= 1;
+    }
+    m_memory.assign(StorageSize(), 0);
+    Attach(m_memory.data());
+}
+
+bool FrecencyStore::Open(const std::filesystem::path& path) {
+    if (!m_file.Open(path, StorageSize())) {
+        return false;
+    }
+    Attach(m_file.Data());
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+    return true;
+}
+
+void FrecencyStore::Close() {
+    if (!m_file.IsOpen()) return;
+    m_file.Close();
+    m_memory.assign(StorageSize(), 0);
+    Attach(m_memory.data());
+}
+
+void FrecencyStore::Attach(uint8_t* storage) {
+    m_header = reinterpret_cast<Header*>(storage);
+    m_records = reinterpret_cast<Record*>(storage + sizeof(Header));
+
+    // A new, foreign or differently sized file starts over, and so does one
+    // whose table is fuller than Bump() allows: probes rely on empty slots
+    bool valid = m_header->magic == kMagic && m_header->version == kVersion && m_header->capacity == m_capacity;
+    if (valid) {
+        uint32_t occupied = 0;
+        for (uint32_t slot = 0; slot < m_capacity; ++slot) {
+            occupied += m_records[slot].key != 0;
+        }
+        valid = occupied == m_header->count && occupied * 4 <= m_capacity * 3;
+    }
+    if (!valid) {
+        std::memset(storage, 0, StorageSize());
+        m_header->magic = kMagic;
+        m_header->version = kVersion;
+        m_header->capacity = m_capacity;
+    }
+}
+
+uint32_t FrecencyStore::Now() {
+    using namespace std::chrono;
+    constexpr int64_t kEpoch = 1577836800; // 2020-01-01T00:00:00Z
+    const int64_t seconds = duration_cast<std::chrono::seconds>(system_clock::now().time_since_epoch()).count();
+    return static_cast<uint32_t>(std::max<int64_t>(seconds - kEpoch, 0) / 60);
+}
+
+uint64_t FrecencyStore::WindowKey(const std::wstring& processName, const std::wstring& title) {
+    // Titles may carry a " (process.exe)" suffix; it is not part of the key
+    std::wstring bareTitle = title;
+    const std::wstring suffix = L" (" + processName + L")";
+    if (!processName.empty() && bareTitle.size() >= suffix.size() &&
+        bareTitle.compare(bareTitle.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        bareTitle.resize(bareTitle.size() - suffix.size());
+    }
+
+    const std::wstring process = CaseFold::Folded(processName, true);
+    const std::wstring normalized = NormalizeTitle(bareTitle);
+
+    uint64_t hash = HashUnits(kFnvOffset, L"W", 1);
+    hash = HashUnits(hash, process.data(), process.size());
+    hash = HashUnits(hash, L"\x1F", 1);
+    hash = HashUnits(hash, normalized.data(), normalized.size());
+    return Finish(hash);
+}
+
+uint64_t FrecencyStore::QueryKey(const std::wstring& foldedQuery) {
+    if (foldedQuery.empty()) return 0;
+    const size_t length = std::min(foldedQuery.size(), kMaxQueryPrefix);
+    uint64_t hash = HashUnits(kFnvOffset, L"Q", 1);
+    return Finish(HashUnits(hash, foldedQuery.data(), length));
+}
+
+uint64_t FrecencyStore::PairKey(uint64_t queryKey, uint64_t windowKey) {
+    return Finish(queryKey * 0x9E3779B97F4A7C15ull + windowKey);
+}
+
+void FrecencyStore::RecordActivation(uint64_t windowKey, const std::wstring& foldedQuery, uint32_t now) {
+    Bump(windowKey, now);
+
+    // Every prefix the user typed on the way led to this window too
+    const size_t length = std::min(foldedQuery.size(), kMaxQueryPrefix);
+    for (size_t prefix = 1; prefix <= length; ++prefix) {
+        Bump(PairKey(QueryKey(foldedQuery.substr(0, prefix)), windowKey), now);
+    }
+}
+
+double FrecencyStore::Boost(uint64_t windowKey, uint64_t queryKey, uint32_t now) const {
+    // Both terms saturate: habits matter, but never outweigh a much better match
+    const double window = Score(windowKey, now);
+    double boost = 12.0 * window / (window + 3.0);
+    if (queryKey != 0) {
+        const double pair = Score(PairKey(queryKey, windowKey), now);
+        boost += 25.0 * pair / (pair + 1.0);
+    }
+    return boost;
+}
+
+double FrecencyStore::Score(uint64_t key, uint32_t now) const {
+    const Record* record = Find(key);
+    return record ? Decayed(*record, now) : 0.0;
+}
+
+size_t FrecencyStore::Count() const {
+    return m_header->count;
+}
+
+double FrecencyStore::Decayed(const Record& record, uint32_t now) const {
+    const double age = now > record.stamp ? static_cast<double>(now - record.stamp) : 0.0;
+    return record.score * std::exp2(-age / m_halfLifeMinutes);
+}
+
+const FrecencyStore::Record* FrecencyStore::Find(uint64_t key) const {
+    // One pass at most: a file changed behind the mapping may have no empty slot
+    const uint32_t mask = m_capacity - 1;
+    uint32_t slot = static_cast<uint32_t>(key) & mask;
+    for (uint32_t probe = 0; probe < m_capacity; ++probe, slot = (slot + 1) & mask) {
+        const Record& record = m_records[slot];
+        if (record.key == key) return &record;
+        if (record.key == 0) return nullptr;
+    }
+    return nullptr;
+}
+
+FrecencyStore::Record* FrecencyStore::FindSlot(uint64_t key) {
+    // The record for `key`, or the empty slot it belongs in; nullptr if neither
+    const uint32_t mask = m_capacity - 1;
+    uint32_t slot = static_cast<uint32_t>(key) & mask;
+    for (uint32_t probe = 0; probe < m_capacity; ++probe, slot = (slot + 1) & mask) {
+        if (m_records[slot].key == key || m_records[slot].key == 0) return &m_records[slot];
+    }
+    return nullptr;
+}
+
+void FrecencyStore::Bump(uint64_t key, uint32_t now) {
+    // Keep the load factor at or below 3/4 so probes stay short
+    if (!Find(key) && (m_header->count + 1) * 4 > m_capacity * 3) {
+        Compact(now);
+    }
+
+    Record* slot = FindSlot(key);
+    if (!slot) {
+        // Only if the file was filled behind the mapping
+        Compact(now);
+        slot = FindSlot(key);
+    }
+
+    Record& record = *slot;
+    if (record.key == 0) {
+        record.key = key;
+        record.score = 0.0f;
+        record.stamp = now;
+        ++m_header->count;
+    }
+    record.score = static_cast<float>(Decayed(record, now) + 1.0);
+    record.stamp = now;
+}
+
+void FrecencyStore::Compact(uint32_t now) {
+    // Keep the stronger half, decayed to now, and reinsert it
+    std::vector<Record> records;
+    records.reserve(m_header->count);
+    for (uint32_t slot = 0; slot < m_capacity; ++slot) {
+        if (m_records[slot].key != 0) {
+            Record record = m_records[slot];
+            record.score = static_cast<float>(Decayed(record, now));
+            record.stamp = now;
+            records.push_back(record);
+        }
+    }
+
+    const size_t keep = std::min<size_t>(records.size(), m_capacity / 2);
+    std::nth_element(records.begin(), records.begin() + keep, records.end(),
+                     [](const Record& a, const Record& b) { return a.score > b.score; });
+
+    std::memset(m_records, 0, size_t(m_capacity) * sizeof(Record));
+    const uint32_t mask = m_capacity - 1;
+    for (size_t i = 0; i < keep; ++i) {
+        uint32_t slot = static_cast<uint32_t>(records[i].key) & mask;
+        while (m_records[slot].key != 0) {
+            slot = (slot + 1) & mask;
+        }
+        m_records[slot] = records[i];
+    }
+    m_header->count = static_cast<uint32_t>(keep);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Activation history with exponential time decay. Remembers how often and
+// how recently each window (process name + normalized title) was picked,
+// and which window was picked for which query prefix, as hashed keys in a
+// fixed-size open-addressed table. The table is the file format: opening
+// the store maps the file and uses it in place, without parsing. Without a
+// file the store keeps its table in memory.
+//
+// Not thread-safe for writers; concurrent Boost() calls are fine while
+// nothing records.
+class FrecencyStore {
+public:
+    static constexpr uint32_t kDefaultCapacity = 4096; // Slots, a power of two
+
+    explicit FrecencyStore(uint32_t capacity = kDefaultCapacity);
+
+    // Maps `path`, starting over if it holds no store of this capacity.
+    // Returns false (and keeps an in-memory table) if it cannot be mapped.
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    void SetHalfLife(double minutes) { m_halfLifeMinutes = minutes > 0 ? minutes : 1.0; }
+
+    // Minutes since 2020-01-01, the store's clock
+    static uint32_t Now();
+
+    // Stable key of a window; titles are normalized so that counters, dirty
+    // markers and case changes do not make it a different window
+    static uint64_t WindowKey(const std::wstring& processName, const std::wstring& title);
+    // Key of a folded query, or 0 for an empty one
+    static uint64_t QueryKey(const std::wstring& foldedQuery);
+
+    // The user picked the window, after typing `foldedQuery` (may be empty)
+    void RecordActivation(uint64_t windowKey, const std::wstring& foldedQuery, uint32_t now);
+
+    // Ranking bonus for the window, higher for windows picked often and
+    // recently, and much higher if picked before for this query
+    double Boost(uint64_t windowKey, uint64_t queryKey, uint32_t now) const;
+
+    // Decayed activation count behind a key
+    double Score(uint64_t key, uint32_t now) const;
+
+    size_t Count() const;
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t count;
+    };
+
+    struct Record {
+        uint64_t key;    // 0 = empty slot
+        float score;     // As of `stamp`
+        uint32_t stamp;  // Store clock
+    };
+    static_assert(sizeof(Record) == 16, "records are packed into the mapped file");
+
+    static constexpr uint32_t kMagic = 0x59434546; // "FECY"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kMaxQueryPrefix = 16;
+
+    static uint64_t PairKey(uint64_t queryKey, uint64_t windowKey);
+
+    size_t StorageSize() const { return sizeof(Header) + size_t(m_capacity) * sizeof(Record); }
+    void Attach(uint8_t* storage);
+    void Bump(uint64_t key, uint32_t now);
+    const Record* Find(uint64_t key) const;
+    Record* FindSlot(uint64_t key);
+    double Decayed(const Record& record, uint32_t now) const;
+    void Compact(uint32_t now);
+
+    uint32_t m_capacity;
+    double m_halfLifeMinutes = 7 * 24 * 60;
+
+    MappedFile m_file;
+    std::vector<uint8_t> m_memory; // Used when there is no file
+    Header* m_header = nullptr;
+    Record* m_records = nullptr;
+};
@@ -0,0 +1,110 @@
+#include "IconAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+IconAtlas::IconAtlas(int cellSize)
+    : m_cellSize(std::max(cellSize, 1)) {
+}
+
+void IconAtlas::SetCellSize(int cellSize) {
+    cellSize = std::max(cellSize, 1);
+    if (cellSize == m_cellSize) return;
+
+    m_cellSize = cellSize;
+    m_rows = 0;
+    m_pixels.clear();
+    m_cells.clear();
+    m_freeSlots.clear();
+    ++m_version;
+}
+
+const IconAtlas::Cell* IconAtlas::Find(Key key) const {
+    const auto it = m_cells.find(key);
+    return it == m_cells.end() ? nullptr : &it->second.cell;
+}
+
+IconAtlas::Cell IconAtlas::SlotCell(uint32_t slot) const {
+    return { static_cast<int>(slot % kColumns) * m_cellSize, static_cast<int>(slot / kColumns) * m_cellSize };
+}
+
+IconAtlas::Cell IconAtlas::Insert(Key key, const uint32_t* pixels) {
+    auto [it, added] = m_cells.try_emplace(key);
+    Entry& entry = it->second;
+    if (added) {
+        if (m_freeSlots.empty()) {
+            // Rows are contiguous, so growing by a row keeps every cell in place
+            const uint32_t first = static_cast<uint32_t>(m_rows) * kColumns;
+            ++m_rows;
+            m_pixels.resize(static_cast<size_t>(Width()) * Height(), 0);
+            for (uint32_t slot = first + kColumns; slot-- > first + 1;) {
+                m_freeSlots.push_back(slot);
+            }
+            entry.slot = first;
+        } else {
+            entry.slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        entry.cell = SlotCell(entry.slot);
+    }
+    entry.sweep = m_sweeps;
+
+    const size_t stride = static_cast<size_t>(Width());
+    uint32_t* target = m_pixels.data() + static_cast<size_t>(entry.cell.y) * stride + entry.cell.x;
+    for (int row = 0; row < m_cellSize; ++row) {
+        std::memcpy(target + row * stride, pixels + static_cast<size_t>(row) * m_cellSize,
+                    static_cast<size_t>(m_cellSize) * sizeof(uint32_t));
+    }
+    ++m_version;
+    return entry.cell;
+}
+
+size_t IconAtlas::Sweep(const std::vector<Key>& live) {
+    const uint64_t sweep = ++m_sweeps;
+    for (Key key : live) {
+        const auto it = m_cells.find(key);
+        if (it != m_cells.end()) it->second.sweep = sweep;
+    }
+
+    size_t freed = 0;
+    for (auto it = m_cells.begin(); it != m_cells.end();) {
+        if (it->second.sweep == sweep) {
+            ++it;
+            continue;
+        }
+        // Lowest slots are handed out first, which keeps the atlas compact
+        m_freeSlots.push_back(it->second.slot);
+        it = m_cells.erase(it);
+        ++freed;
+    }
+    if (freed) {
+        std::sort(m_freeSlots.begin(), m_freeSlots.end(), std::greater<uint32_t>());
+    }
+    return freed;
+}
+
+void IconAtlas::FromBlackAndWhite(const uint32_t* onBlack, const uint32_t* onWhite, uint32_t* premultiplied,
+                                  size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t black = onBlack[i];
+        const uint32_t white = onWhite[i];
+
+        // Each channel over white minus over black is 255 - alpha; the
+        // green channel stands in for all three
+        const int shown = static_cast<int>((white >> 8) & 0xFF) - static_cast<int>((black >> 8) & 0xFF);
+        const uint32_t alpha = static_cast<uint32_t>(255 - std::clamp(shown, 0, 255));
+
+        // Premultiplied colour can never exceed alpha
+        const uint32_t r = std::min((black >> 16) & 0xFF, alpha);
+        const uint32_t g = std::min((black >> 8) & 0xFF, alpha);
+        const uint32_t b = std::min(black & 0xFF, alpha);
+        premultiplied[i] = (alpha << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+uint32_t IconAtlas::Premultiply(uint32_t argb) {
+    const uint32_t alpha = argb >> 24;
+    auto scale = [alpha](uint32_t channel) { return (channel * alpha + 127) / 255; };
+    return (alpha << 24) | (scale((argb >> 16) & 0xFF) << 16) | (scale((argb >> 8) & 0xFF) << 8) |
+           scale(argb & 0xFF);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Icons at one size, premultiplied ARGB, packed into a single bitmap of
+// square cells. Each distinct icon, by key, is rendered into a cell once;
+// every row showing it blits from there. Cells of icons no longer listed
+// are recycled by Sweep(). Platform-neutral: the caller supplies the
+// rendered pixels and the blit.
+class IconAtlas {
+public:
+    using Key = uint64_t;
+
+    struct Cell {
+        int x = 0; // Pixel offset into the atlas
+        int y = 0;
+    };
+
+    static constexpr int kColumns = 16;
+
+    explicit IconAtlas(int cellSize = 16);
+
+    // A new size (configured, or after a DPI change) drops every icon
+    void SetCellSize(int cellSize);
+    int CellSize() const { return m_cellSize; }
+
+    // nullptr if `key` has not been added
+    const Cell* Find(Key key) const;
+
+    // Adds `key` with CellSize() x CellSize() premultiplied pixels, rows
+    // top-down, and returns its cell. Free cells are reused before the
+    // atlas grows by a row.
+    Cell Insert(Key key, const uint32_t* pixels);
+
+    // Frees the cells of every key not in `live`; returns how many
+    size_t Sweep(const std::vector<Key>& live);
+
+    // The whole atlas, rows top-down
+    const uint32_t* Pixels() const { return m_pixels.data(); }
+    int Width() const { return kColumns * m_cellSize; }
+    int Height() const { return m_rows * m_cellSize; }
+
+    // Bumped whenever Pixels() changes, so a copy knows to update
+    uint64_t Version() const { return m_version; }
+    size_t Size() const { return m_cells.size(); }
+
+    // Premultiplied pixels from two renders of the same icon, over black
+    // and over white: alpha is what the backgrounds do not show through,
+    // and the render over black is already premultiplied. Works for
+    // alpha-channel and masked icons alike.
+    static void FromBlackAndWhite(const uint32_t* onBlack, const uint32_t* onWhite, uint32_t* premultiplied,
+                                  size_t count);
+
+    // Premultiplies straight-alpha ARGB
+    static uint32_t Premultiply(uint32_t argb);
+
+private:
+    struct Entry {
+        Cell cell;
+        uint32_t slot = 0;
+        uint64_t sweep = 0; // Last Sweep() that found it live
+    };
+
+    Cell SlotCell(uint32_t slot) const;
+
+    int m_cellSize;
+    int m_rows = 0;
+    std::vector<uint32_t> m_pixels;
+    std::unordered_map<Key, Entry> m_cells;
+    std::vector<uint32_t> m_freeSlots;
+    uint64_t m_sweeps = 0;
+    uint64_t m_version = 0;
+};
@@ -0,0 +1,61 @@
+#include "IconFetcher.h"
+#include "Utils.h"
+#include <algorithm>
+
+IconFetcher::IconFetcher(ReadyHandler onReady)
+    : m_state(std::make_shared<State>()) {
+    m_state->onReady = std::move(onReady);
+    std::thread([state = m_state] { Run(state); }).detach();
+}
+
+IconFetcher::~IconFetcher() {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stop = true;
+    }
+    m_state->wake.notify_one();
+}
+
+void IconFetcher::Request(HWND hwnd) {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (std::find(m_state->requests.begin(), m_state->requests.end(), hwnd) != m_state->requests.end()) return;
+        m_state->requests.push_back(hwnd);
+    }
+    m_state->wake.notify_one();
+}
+
+void IconFetcher::TakeResults(std::vector<Result>& results) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    results.insert(results.end(), m_state->results.begin(), m_state->results.end());
+    m_state->results.clear();
+}
+
+void IconFetcher::Run(const std::shared_ptr<State>& state) {
+    for (;;) {
+        HWND hwnd;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->wake.wait(lock, [&] { return state->stop || !state->requests.empty(); });
+            if (state->stop) return;
+            hwnd = state->requests.front();
+        }
+
+        // A window can hold the thread for up to kTimeoutMs; SMTO_ABORTIFHUNG
+        // keeps truly hung ones from doing even that
+        HICON icon = nullptr;
+        const bool answered = Utils::QueryWindowIcon(hwnd, kTimeoutMs, icon);
+
+        // The handler is called under the lock, so that once the destructor
+        // has set `stop` it is never called again
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->stop) return;
+        state->requests.erase(state->requests.begin());
+        // Still silent: it keeps its placeholder until asked again
+        if (answered && IsWindow(hwnd)) {
+            const bool notify = state->results.empty();
+            state->results.push_back({ hwnd, icon });
+            if (notify && state->onReady) state->onReady();
+        }
+    }
+}
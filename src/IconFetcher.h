@@ -0,0 +1,56 @@
+#pragma once
+
+#include <windows.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Asks windows that missed the enumeration deadline for their icon again,
+// on a thread of its own and with a much longer timeout, so that a hung
+// application delays only its own icon. Each request is tried once;
+// answers are announced through the ready handler (called on the fetcher
+// thread), after which TakeResults() hands them over. Destroying the fetcher
+// never waits for a window: the thread is detached, finishes the call in
+// flight on its own and then exits without calling the handler.
+class IconFetcher {
+public:
+    struct Result {
+        HWND hwnd = nullptr;
+        HICON icon = nullptr; // Owned by the window; null if it had none
+    };
+
+    using ReadyHandler = std::function<void()>;
+
+    explicit IconFetcher(ReadyHandler onReady);
+    ~IconFetcher();
+
+    IconFetcher(const IconFetcher&) = delete;
+    IconFetcher& operator=(const IconFetcher&) = delete;
+
+    // Queues `hwnd` unless it is already waiting
+    void Request(HWND hwnd);
+
+    // Moves the answers so far to the end of `results`
+    void TakeResults(std::vector<Result>& results);
+
+private:
+    static constexpr UINT kTimeoutMs = 5000;
+
+    // Shared with the thread, which may outlive the fetcher by one request
+    struct State {
+        ReadyHandler onReady;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<HWND> requests;
+        std::vector<Result> results;
+        bool stop = false;
+    };
+
+    static void Run(const std::shared_ptr<State>& state);
+
+    std::shared_ptr<State> m_state;
+};
@@ -0,0 +1,168 @@
+#include "KeystrokeTrace.h"
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+    // wchar_t is UTF-16 on Windows and UTF-32 elsewhere; the file is UTF-8 on both
+    void AppendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
+    void AppendWide(std::wstring& out, uint32_t code) {
+        if (sizeof(wchar_t) == 2 && code >= 0x10000) {
+            code -= 0x10000;
+            out += static_cast<wchar_t>(0xD800 + (code >> 10));
+            out += static_cast<wchar_t>(0xDC00 + (code & 0x3FF));
+        } else {
+            out += static_cast<wchar_t>(code);
+        }
+    }
+
+    std::string Escape(const std::wstring& text) {
+        std::string out;
+        out.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            uint32_t code = static_cast<uint32_t>(text[i]);
+            if (code >= 0xD800 && code <= 0xDBFF && i + 1 < text.size()) {
+                const uint32_t low = static_cast<uint32_t>(text[i + 1]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    ++i;
+                }
+            }
+            switch (code) {
+            case '\\': out += "\\\\"; break;
+            case '\t': out += "\\t"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: AppendUtf8(out, code); break;
+            }
+        }
+        return out;
+    }
+
+    bool Unescape(const std::string& text, std::wstring& out) {
+        out.clear();
+        for (size_t i = 0; i < text.size();) {
+            const auto byte = static_cast<unsigned char>(text[i]);
+            if (byte == '\\') {
+                if (i + 1 >= text.size()) return false;
+                switch (text[i + 1]) {
+                case '\\': out += L'\\'; break;
+                case 't': out += L'\t'; break;
+                case 'n': out += L'\n'; break;
+                case 'r': out += L'\r'; break;
+                default: return false;
+                }
+                i += 2;
+                continue;
+            }
+
+            size_t length = byte < 0x80 ? 1 : (byte >> 5) == 0x6 ? 2 : (byte >> 4) == 0xE ? 3 : (byte >> 3) == 0x1E ? 4 : 0;
+            if (length == 0 || i + length > text.size()) return false;
+            uint32_t code = length == 1 ? byte : byte & (0x7F >> length);
+            for (size_t k = 1; k < length; ++k) {
+                const auto next = static_cast<unsigned char>(text[i + k]);
+                if ((next & 0xC0) != 0x80) return false;
+                code = (code << 6) | (next & 0x3F);
+            }
+            AppendWide(out, code);
+            i += length;
+        }
+        return true;
+    }
+
+    // Splits "<head>\t<tail>"; false if there is no tab
+    bool SplitTab(const std::string& text, std::string& head, std::string& tail) {
+        const size_t tab = text.find('\t');
+        if (tab == std::string::npos) return false;
+        head = text.substr(0, tab);
+        tail = text.substr(tab + 1);
+        return true;
+    }
+}
+
+void KeystrokeTrace::Clear() {
+    stripDiacritics = true;
+    windows.clear();
+    keystrokes.clear();
+    chosen = -1;
+}
+
+bool KeystrokeTrace::AppendTo(const std::filesystem::path& path) const {
+    std::string text = "session " + std::string(stripDiacritics ? "1" : "0") + "\n";
+    for (const Window& window : windows) {
+        text += "window " + Escape(window.processName) + "\t" + Escape(window.title) + "\n";
+    }
+    for (const Keystroke& keystroke : keystrokes) {
+        text += "key " + std::to_string(keystroke.elapsedMs) + "\t" + Escape(keystroke.query) + "\n";
+    }
+    text += "chosen " + std::to_string(chosen) + "\nend\n";
+
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return static_cast<bool>(file.flush());
+}
+
+bool KeystrokeTrace::Load(const std::filesystem::path& path, std::vector<KeystrokeTrace>& sessions) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    KeystrokeTrace session;
+    bool open = false;
+    std::string line;
+    std::string head;
+    std::string tail;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        const size_t space = line.find(' ');
+        const std::string record = line.substr(0, space);
+        const std::string rest = space == std::string::npos ? std::string() : line.substr(space + 1);
+
+        if (record == "session") {
+            if (open) return false;
+            session.Clear();
+            session.stripDiacritics = rest != "0";
+            open = true;
+        } else if (!open) {
+            return false;
+        } else if (record == "window") {
+            Window window;
+            if (!SplitTab(rest, head, tail) || !Unescape(head, window.processName) || !Unescape(tail, window.title)) {
+                return false;
+            }
+            session.windows.push_back(std::move(window));
+        } else if (record == "key") {
+            Keystroke keystroke;
+            if (!SplitTab(rest, head, tail) || !Unescape(tail, keystroke.query)) return false;
+            keystroke.elapsedMs = static_cast<uint32_t>(std::strtoul(head.c_str(), nullptr, 10));
+            session.keystrokes.push_back(std::move(keystroke));
+        } else if (record == "chosen") {
+            session.chosen = std::strtoll(rest.c_str(), nullptr, 10);
+            if (session.chosen >= static_cast<int64_t>(session.windows.size())) return false;
+        } else if (record == "end") {
+            sessions.push_back(std::move(session));
+            session = KeystrokeTrace();
+            open = false;
+        } else {
+            return false;
+        }
+    }
+    return true; // A session cut off by a crash is dropped
+}
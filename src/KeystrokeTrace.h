@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// One switcher session as recorded for offline replay: the windows the user
+// chose from, the query after every keystroke and the window finally
+// activated. Sessions are appended to a UTF-8 text file, one line per
+// record:
+//
+//   session <strip diacritics 0|1>
+//   window <process name>\t<title>
+//   key <milliseconds since the switcher opened>\t<query>
+//   chosen <window index, -1 if dismissed>
+//   end
+//
+// Backslash, tab and line breaks inside names are escaped as \\, \t, \n, \r.
+struct KeystrokeTrace {
+    struct Window {
+        std::wstring title;
+        std::wstring processName;
+    };
+
+    struct Keystroke {
+        uint32_t elapsedMs = 0;
+        std::wstring query; // As typed, before folding
+    };
+
+    bool stripDiacritics = true;
+    std::vector<Window> windows;
+    std::vector<Keystroke> keystrokes;
+    int64_t chosen = -1;
+
+    void Clear();
+
+    // Appends this session to `path`; false if the file cannot be written
+    bool AppendTo(const std::filesystem::path& path) const;
+
+    // Reads every complete session in `path`; false if it cannot be read or
+    // is malformed
+    static bool Load(const std::filesystem::path& path, std::vector<KeystrokeTrace>& sessions);
+};
@@ -0,0 +1,74 @@
+#include "ProcessTable.h"
+#include "Config.h"
+#include "CaseFold.h"
+#include <algorithm>
+#include <tlhelp32.h>
+
+ULONGLONG ProcessTable::Now() {
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    return (static_cast<ULONGLONG>(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+}
+
+bool ProcessTable::Refresh() {
+    m_processes.clear();
+    m_snapshotTime = Now();
+
+    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (hSnapshot == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    PROCESSENTRY32W pe32;
+    pe32.dwSize = sizeof(PROCESSENTRY32W);
+
+    std::wstring folded;
+    if (Process32FirstW(hSnapshot, &pe32)) {
+        do {
+            Process& process = m_processes[pe32.th32ProcessID];
+            process.name = pe32.szExeFile;
+
+            // Exclusions are matched once per process, not once per window
+            folded.assign(process.name);
+            CaseFold::Fold(folded, Config::STRIP_DIACRITICS);
+            process.excluded = std::find(Config::EXCLUDED_PROCESSES.begin(), Config::EXCLUDED_PROCESSES.end(),
+                                         folded) != Config::EXCLUDED_PROCESSES.end();
+        } while (Process32NextW(hSnapshot, &pe32));
+    }
+
+    CloseHandle(hSnapshot);
+    return true;
+}
+
+const ProcessTable::Process* ProcessTable::Find(DWORD processId) const {
+    const auto it = m_processes.find(processId);
+    return it == m_processes.end() ? nullptr : &it->second;
+}
+
+const std::wstring& ProcessTable::Name(DWORD processId) const {
+    static const std::wstring unknown;
+    const Process* process = Find(processId);
+    return process ? process->name : unknown;
+}
+
+bool ProcessTable::Current(DWORD processId, ULONGLONG windowSeen) {
+    const auto it = m_processes.find(processId);
+    if (it == m_processes.end()) return false;
+    // The window already existed when its owner proved current, so it is
+    // that owner's; title changes of listed windows never get this far
+    if (windowSeen < it->second.checkedAt) return true;
+
+    const ULONGLONG checkedAt = Now();
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (!hProcess) return true;
+    FILETIME created, exited, kernel, user;
+    const BOOL known = GetProcessTimes(hProcess, &created, &exited, &kernel, &user);
+    CloseHandle(hProcess);
+    if (!known) return true;
+
+    // Started after the snapshot: the id belonged to another process then
+    const ULONGLONG createdAt = (static_cast<ULONGLONG>(created.dwHighDateTime) << 32) | created.dwLowDateTime;
+    if (createdAt > m_snapshotTime) return false;
+    it->second.checkedAt = checkedAt;
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <unordered_map>
+
+// Names of the running processes, from a single Toolhelp snapshot. Built
+// once per window refresh, so that enumeration looks names up here rather
+// than walking the whole process list for every window. A process id seen
+// in one table always names the process that owned it when the table was
+// built. A table kept across refreshes may outlive that process and see its
+// id reused; Current() tells, from the creation time of the id's owner now.
+class ProcessTable {
+public:
+    struct Process {
+        std::wstring name;       // Executable file name, e.g. "explorer.exe"
+        bool excluded = false;   // Listed in Config::EXCLUDED_PROCESSES
+        ULONGLONG checkedAt = 0; // When its id last proved current, 0 = never
+    };
+
+    // The system time in FILETIME units, as Current() compares it
+    static ULONGLONG Now();
+
+    // Replaces the table with the processes running now; false if the
+    // snapshot failed (the table is then empty)
+    bool Refresh();
+
+    // nullptr if the process is unknown (or exited before the snapshot)
+    const Process* Find(DWORD processId) const;
+    const std::wstring& Name(DWORD processId) const;
+
+    // Whether the table knows the process that owns `processId` for a
+    // window first seen at `windowSeen`, i.e. it is listed and was created
+    // before the snapshot. The process is opened only if the window is newer
+    // than the id's last check, since an older window's owner was the one
+    // checked; if opening fails, only whether it is listed.
+    bool Current(DWORD processId, ULONGLONG windowSeen);
+
+    size_t Size() const { return m_processes.size(); }
+
+private:
+    std::unordered_map<DWORD, Process> m_processes;
+    ULONGLONG m_snapshotTime = 0; // FILETIME units, taken before the snapshot
+};
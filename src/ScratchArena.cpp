@@ -0,0 +1,26 @@
+#include "ScratchArena.h"
+
+ScratchArena::ScratchArena(size_t initialBytes)
+    : m_buffer(initialBytes) {
+}
+
+std::pmr::memory_resource* ScratchArena::Begin() {
+    m_pass.reset(); // Returns last pass's overflow to the heap
+
+    if (m_overflow.bytes > 0) {
+        m_buffer.resize(2 * (m_buffer.size() + m_overflow.bytes));
+        m_overflow.bytes = 0;
+    }
+
+    m_pass.emplace(m_buffer.data(), m_buffer.size(), &m_overflow);
+    return &*m_pass;
+}
+
+void* ScratchArena::Overflow::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void ScratchArena::Overflow::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
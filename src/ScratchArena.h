@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+// Bump allocator for the temporaries of one filter pass. Begin() hands out
+// a fresh monotonic resource over a buffer the arena keeps between passes,
+// so steady-state passes never reach the global heap. When a pass outgrows
+// the buffer, the overflow comes from the heap once and the buffer is
+// enlarged for the next pass. Single-threaded, like its owner.
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t initialBytes = 16 * 1024);
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Releases everything handed out since the previous Begin()
+    std::pmr::memory_resource* Begin();
+
+    size_t Capacity() const { return m_buffer.size(); }
+
+private:
+    // Heap fallback that remembers how far a pass overflowed
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::vector<std::byte> m_buffer;
+    Overflow m_overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> m_pass;
+};
@@ -0,0 +1,165 @@
+#include "ScriptedWindowSource.h"
+#include <algorithm>
+
+ScriptedWindowSource::Window* ScriptedWindowSource::Find(WindowHandle handle) {
+    auto it = std::find_if(m_windows.begin(), m_windows.end(),
+                           [handle](const Window& window) { return window.info.handle == handle; });
+    return it == m_windows.end() ? nullptr : &*it;
+}
+
+void ScriptedWindowSource::Raise(WindowHandle handle) {
+    auto it = std::find_if(m_windows.begin(), m_windows.end(),
+                           [handle](const Window& window) { return window.info.handle == handle; });
+    if (it != m_windows.end()) {
+        std::rotate(m_windows.begin(), it, it + 1);
+    }
+}
+
+void ScriptedWindowSource::Queue(WindowEvent::Kind kind, WindowHandle handle) {
+    // Called with the lock held; the handler runs after it is released
+    if (m_dropEvents) return;
+    m_events.push_back({ kind, handle });
+}
+
+WindowHandle ScriptedWindowSource::Create(const std::wstring& title, const std::wstring& processName,
+                                          uint32_t processId, bool visible) {
+    ChangeHandler notify;
+    WindowHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        handle = m_nextHandle++;
+        Window window;
+        window.info.handle = handle;
+        window.info.processId = processId;
+        window.info.title = title;
+        window.info.processName = processName;
+        window.info.className = L"ScriptedWindow";
+        window.visible = visible;
+        m_windows.insert(m_windows.begin(), std::move(window));
+
+        Queue(WindowEvent::Kind::Created, handle);
+        if (visible) Queue(WindowEvent::Kind::Shown, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+    return handle;
+}
+
+void ScriptedWindowSource::Destroy(WindowHandle handle) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_windows.erase(std::remove_if(m_windows.begin(), m_windows.end(),
+                                       [handle](const Window& window) { return window.info.handle == handle; }),
+                        m_windows.end());
+        Queue(WindowEvent::Kind::Destroyed, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+void ScriptedWindowSource::Show(WindowHandle handle) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Window* window = Find(handle);
+        if (!window) return;
+        window->visible = true;
+        Raise(handle);
+        Queue(WindowEvent::Kind::Shown, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+void ScriptedWindowSource::Hide(WindowHandle handle) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Window* window = Find(handle);
+        if (!window) return;
+        window->visible = false;
+        Queue(WindowEvent::Kind::Hidden, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+void ScriptedWindowSource::Rename(WindowHandle handle, const std::wstring& title) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Window* window = Find(handle);
+        if (!window) return;
+        window->info.title = title;
+        Queue(WindowEvent::Kind::NameChanged, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+void ScriptedWindowSource::Activate(WindowHandle handle) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!Find(handle)) return;
+        Raise(handle);
+        Queue(WindowEvent::Kind::Foreground, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+void ScriptedWindowSource::SetMinimized(WindowHandle handle, bool minimized) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Window* window = Find(handle);
+        if (!window) return;
+        window->info.isMinimized = minimized;
+        Queue(WindowEvent::Kind::StateChanged, handle);
+        notify = m_onChange;
+    }
+    if (notify) notify();
+}
+
+std::vector<WindowHandle> ScriptedWindowSource::Handles() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<WindowHandle> handles;
+    for (const Window& window : m_windows) {
+        handles.push_back(window.info.handle);
+    }
+    return handles;
+}
+
+bool ScriptedWindowSource::Start(ChangeHandler onChange) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onChange = std::move(onChange);
+    return true;
+}
+
+void ScriptedWindowSource::Stop() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onChange = nullptr;
+}
+
+void ScriptedWindowSource::TakeEvents(std::vector<WindowEvent>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    events.insert(events.end(), m_events.begin(), m_events.end());
+    m_events.clear();
+}
+
+bool ScriptedWindowSource::Read(WindowHandle handle, TrackedWindow& window) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Window* found = Find(handle);
+    if (!found || !Listed(*found)) return false;
+    window = found->info;
+    return true;
+}
+
+void ScriptedWindowSource::Enumerate(std::vector<TrackedWindow>& windows) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const Window& window : m_windows) {
+        if (Listed(window)) windows.push_back(window.info);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "WindowSource.h"
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A desktop that exists only in memory, for exercising WindowTracker and
+// the code behind it without Win32. Each scripting call changes the
+// desktop and queues the events a real desktop would raise; events can be
+// dropped on purpose to test reconciliation. Windows are listed when
+// visible and titled, like IsValidWindow's basic rules.
+class ScriptedWindowSource : public WindowSource {
+public:
+    WindowHandle Create(const std::wstring& title, const std::wstring& processName, uint32_t processId,
+                        bool visible = true);
+    void Destroy(WindowHandle handle);
+    void Show(WindowHandle handle);
+    void Hide(WindowHandle handle);
+    void Rename(WindowHandle handle, const std::wstring& title);
+    void Activate(WindowHandle handle);
+    void SetMinimized(WindowHandle handle, bool minimized);
+
+    // Changes made while set raise no events, as if the hook missed them
+    void SetDropEvents(bool drop) { m_dropEvents = drop; }
+
+    // Handles of every window that exists, listed or not, topmost first
+    std::vector<WindowHandle> Handles() const;
+
+    // WindowSource
+    bool Start(ChangeHandler onChange) override;
+    void Stop() override;
+    void TakeEvents(std::vector<WindowEvent>& events) override;
+    bool Read(WindowHandle handle, TrackedWindow& window) override;
+    void Enumerate(std::vector<TrackedWindow>& windows) override;
+
+private:
+    struct Window {
+        TrackedWindow info;
+        bool visible = false;
+    };
+
+    Window* Find(WindowHandle handle);
+    void Raise(WindowHandle handle);
+    void Queue(WindowEvent::Kind kind, WindowHandle handle);
+    static bool Listed(const Window& window) { return window.visible && !window.info.title.empty(); }
+
+    mutable std::mutex m_mutex;
+    std::vector<Window> m_windows; // Topmost first
+    std::vector<WindowEvent> m_events;
+    ChangeHandler m_onChange;
+    WindowHandle m_nextHandle = 0x10000;
+    bool m_dropEvents = false;
+};
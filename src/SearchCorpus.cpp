@@ -0,0 +1,58 @@
+#include "SearchCorpus.h"
+#include "CharMask.h"
+#include "CaseFold.h"
+
+void SearchCorpus::Clear() {
+    m_text.clear();
+    m_titleOffsets.clear();
+    m_titleLengths.clear();
+    m_processOffsets.clear();
+    m_processLengths.clear();
+    m_sources.clear();
+    m_masks.clear();
+    m_wordStarts.clear();
+    m_wordOffsets.clear();
+    m_titleWordCounts.clear();
+    m_processWordCounts.clear();
+}
+
+void SearchCorpus::Reserve(size_t entries, size_t chars) {
+    m_text.reserve(chars);
+    m_titleOffsets.reserve(entries);
+    m_titleLengths.reserve(entries);
+    m_processOffsets.reserve(entries);
+    m_processLengths.reserve(entries);
+    m_sources.reserve(entries);
+    m_masks.reserve(entries);
+    m_wordStarts.reserve(chars / 4);
+    m_wordOffsets.reserve(entries);
+    m_titleWordCounts.reserve(entries);
+    m_processWordCounts.reserve(entries);
+}
+
+uint32_t SearchCorpus::AppendFolded(const std::wstring& text) {
+    const uint32_t offset = static_cast<uint32_t>(m_text.size());
+    m_text.insert(m_text.end(), text.begin(), text.end());
+    CaseFold::Fold(m_text.data() + offset, text.size(), m_stripDiacritics);
+    return offset;
+}
+
+void SearchCorpus::Add(const std::wstring& title, const std::wstring& processName, uint32_t source) {
+    // Humps are only visible before folding
+    m_wordOffsets.push_back(static_cast<uint32_t>(m_wordStarts.size()));
+    m_titleWordCounts.push_back(static_cast<uint32_t>(WordBoundaries::Find(title.data(), title.size(), m_wordStarts)));
+    m_processWordCounts.push_back(
+        static_cast<uint32_t>(WordBoundaries::Find(processName.data(), processName.size(), m_wordStarts)));
+
+    const uint32_t titleOffset = AppendFolded(title);
+    const uint32_t processOffset = AppendFolded(processName);
+
+    m_titleOffsets.push_back(titleOffset);
+    m_titleLengths.push_back(static_cast<uint32_t>(title.size()));
+    m_processOffsets.push_back(processOffset);
+    m_processLengths.push_back(static_cast<uint32_t>(processName.size()));
+    m_sources.push_back(source);
+
+    // Title and process name are contiguous in the buffer
+    m_masks.push_back(CharMask::Compute(m_text.data() + titleOffset, title.size() + processName.size()));
+}
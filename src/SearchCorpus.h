@@ -0,0 +1,62 @@
+#pragma once
+
+#include "WordStarts.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Structure-of-arrays copy of one window snapshot, built by the updater when
+// it publishes a snapshot. Every title and process name is folded once into
+// a single contiguous buffer, so filtering never touches std::wstring
+// objects or case mapping per keystroke. Word starts are found once per
+// entry as well, for word-start and acronym matching.
+class SearchCorpus {
+public:
+    void Clear();
+    void Reserve(size_t entries, size_t chars);
+
+    // Whether Add() also strips diacritics; queries must be folded the same way
+    void SetStripDiacritics(bool strip) { m_stripDiacritics = strip; }
+    bool StripDiacritics() const { return m_stripDiacritics; }
+
+    // Folds and appends one entry. `source` is the index of the window in
+    // the snapshot the corpus was built from.
+    void Add(const std::wstring& title, const std::wstring& processName, uint32_t source);
+
+    size_t Size() const { return m_sources.size(); }
+    bool Empty() const { return m_sources.empty(); }
+
+    const wchar_t* Title(size_t i) const { return m_text.data() + m_titleOffsets[i]; }
+    size_t TitleLength(size_t i) const { return m_titleLengths[i]; }
+    const wchar_t* Process(size_t i) const { return m_text.data() + m_processOffsets[i]; }
+    size_t ProcessLength(size_t i) const { return m_processLengths[i]; }
+    uint32_t Source(size_t i) const { return m_sources[i]; }
+
+    WordStarts TitleWords(size_t i) const { return {m_wordStarts.data() + m_wordOffsets[i], m_titleWordCounts[i]}; }
+    WordStarts ProcessWords(size_t i) const {
+        return {m_wordStarts.data() + m_wordOffsets[i] + m_titleWordCounts[i], m_processWordCounts[i]};
+    }
+
+    // CharMask of title and process name, packed for the prefilter
+    uint64_t Mask(size_t i) const { return m_masks[i]; }
+    const uint64_t* Masks() const { return m_masks.data(); }
+
+    size_t TextLength() const { return m_text.size(); }
+
+private:
+    uint32_t AppendFolded(const std::wstring& text);
+
+    std::vector<wchar_t> m_text;
+    std::vector<uint32_t> m_titleOffsets;
+    std::vector<uint32_t> m_titleLengths;
+    std::vector<uint32_t> m_processOffsets;
+    std::vector<uint32_t> m_processLengths;
+    std::vector<uint32_t> m_sources;
+    std::vector<uint64_t> m_masks;
+    std::vector<uint16_t> m_wordStarts;      // Title then process name, per entry
+    std::vector<uint32_t> m_wordOffsets;
+    std::vector<uint32_t> m_titleWordCounts;
+    std::vector<uint32_t> m_processWordCounts;
+    bool m_stripDiacritics = true;
+};
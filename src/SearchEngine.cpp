@@ -0,0 +1,327 @@
+#include "SearchEngine.h"
+#include "CharMask.h"
+#include <algorithm>
+
+SearchEngine::SearchEngine() {
+}
+
+SearchEngine::~SearchEngine() {
+}
+
+void SearchEngine::SetWorkerCount(size_t threads) {
+    if (m_pool && threads == m_workerCount) return;
+    m_workerCount = threads;
+    m_pool.reset(); // Recreated on the next parallel pass
+}
+
+void SearchEngine::SetVerifyPrefilter(bool verify, PrefilterMissHandler onMiss) {
+    m_verifyPrefilter = verify;
+    m_onPrefilterMiss = std::move(onMiss);
+}
+
+void SearchEngine::SetScoringPreset(ScoringPreset preset) {
+    if (preset == m_preset) return;
+    m_preset = preset;
+    ClearCache();
+    Reset();
+}
+
+void SearchEngine::SetCacheCapacity(size_t queries) {
+    m_cacheCapacity = queries;
+    if (m_cache.size() > queries) {
+        m_cache.clear();
+    }
+}
+
+void SearchEngine::ClearCache() {
+    // Keeps the slots and their buffers; an empty query never matches
+    for (CachedResults& cached : m_cache) {
+        cached.query.clear();
+        cached.results.Clear();
+        cached.lastUse = 0;
+    }
+}
+
+void SearchEngine::Reset() {
+    m_boundQuery.clear();
+}
+
+template <typename Policy>
+double SearchEngine::ScoreEntry(const SearchCorpus& corpus, size_t entry, const BasicSearchScorer<Policy>& scorer,
+                                EntryBound* bound) {
+    const WordStarts titleWords = corpus.TitleWords(entry);
+    double titleScore = bound ? scorer.ScoreTarget(corpus.Title(entry), corpus.TitleLength(entry), titleWords,
+                                                   bound->title)
+                              : scorer.ScoreTarget(corpus.Title(entry), corpus.TitleLength(entry), titleWords);
+    if constexpr (Policy::kAcronyms) {
+        const double acronym = scorer.AcronymScore(corpus.Title(entry), titleWords);
+        titleScore = std::max(titleScore, acronym);
+        if (bound) bound->acronym = acronym;
+    }
+    double processScore = 0.0;
+    if constexpr (Policy::kScoreProcess) {
+        const WordStarts processWords = corpus.ProcessWords(entry);
+        processScore = bound ? scorer.ScoreTarget(corpus.Process(entry), corpus.ProcessLength(entry), processWords,
+                                                  bound->process)
+                             : scorer.ScoreTarget(corpus.Process(entry), corpus.ProcessLength(entry), processWords);
+    }
+    if (bound) bound->queryLength = scorer.Query().size();
+    return BasicSearchScorer<Policy>::CombineScores(titleScore, processScore);
+}
+
+bool SearchEngine::Filter(const SearchCorpus& corpus, uint64_t generation, const std::wstring& foldedQuery,
+                          size_t rankHint, SearchResults& results) {
+    results.Clear();
+
+    if (foldedQuery.empty()) {
+        results.AssignAll(corpus.Size());
+        Reset();
+        return true;
+    }
+
+    if (LookupCache(foldedQuery, generation, results)) {
+        return true;
+    }
+
+    switch (m_preset) {
+    case ScoringPreset::TitleOnly:
+        return FilterWith<TitleOnlyScoring>(corpus, generation, foldedQuery, rankHint, results);
+    case ScoringPreset::ProcessFirst:
+        return FilterWith<ProcessFirstScoring>(corpus, generation, foldedQuery, rankHint, results);
+    case ScoringPreset::Balanced:
+        break;
+    }
+    return FilterWith<BalancedScoring>(corpus, generation, foldedQuery, rankHint, results);
+}
+
+template <typename Policy>
+bool SearchEngine::FilterWith(const SearchCorpus& corpus, uint64_t generation, const std::wstring& foldedQuery,
+                              size_t rankHint, SearchResults& results) {
+    std::pmr::memory_resource* scratch = m_scratch.Begin();
+    const BasicSearchScorer<Policy> scorer(foldedQuery, scratch);
+
+    // If the query only grew since the last pass over this same snapshot,
+    // entries scored for a shorter prefix of it are skipped while their
+    // bound for the longer query stays under the threshold. The score is
+    // not monotone in the query length (the fuzzy ratio can rise), so
+    // entries are never dropped just because they failed before. Anything
+    // else (backspace, edits, a fresh snapshot) starts over.
+    const bool narrowing = !m_boundQuery.empty() &&
+                           m_boundGeneration == generation &&
+                           foldedQuery.size() > m_boundQuery.size() &&
+                           foldedQuery.compare(0, m_boundQuery.size(), m_boundQuery) == 0;
+    if (!narrowing) {
+        ++m_boundEpoch;
+        m_bounds.resize(corpus.Size());
+    }
+
+    // Drop entries that lack too many query characters before scoring
+    const CharMaskPrefilter prefilter(foldedQuery, &BasicSearchScorer<Policy>::MayMatchWithMissing);
+    m_candidates.clear();
+    prefilter.Filter(corpus.Masks(), corpus.Size(), m_candidates);
+
+    if (narrowing) {
+        m_candidates.erase(std::remove_if(m_candidates.begin(), m_candidates.end(),
+                                          [&](size_t entry) {
+                                              const EntryBound& b = m_bounds[entry];
+                                              if (b.epoch != m_boundEpoch) return false;
+                                              const double bound = BasicSearchScorer<Policy>::ExtendedBound(
+                                                  b.queryLength, foldedQuery.size() - b.queryLength, b.title,
+                                                  corpus.TitleLength(entry), b.acronym, b.process,
+                                                  corpus.ProcessLength(entry));
+                                              return !BasicSearchScorer<Policy>::MayMatchExtended(bound);
+                                          }),
+                           m_candidates.end());
+    }
+
+    bool completed;
+    if (m_parallelThreshold > 0 && m_candidates.size() >= m_parallelThreshold) {
+        completed = ScoreParallel(corpus, scorer, std::max<size_t>(rankHint, 1), results);
+    } else {
+        completed = ScoreSequential(corpus, scorer, results);
+        if (completed) results.EnsureRanked(rankHint);
+    }
+    if (!completed) {
+        // Some bounds may already be for this query, which is not a prefix of m_boundQuery
+        Reset();
+        return false;
+    }
+    m_boundQuery = foldedQuery;
+    m_boundGeneration = generation;
+
+    if (m_verifyPrefilter) {
+        VerifyPrefilter(corpus, scorer, scratch);
+    }
+
+    StoreInCache(foldedQuery, generation, results);
+    return true;
+}
+
+bool SearchEngine::LookupCache(const std::wstring& foldedQuery, uint64_t generation, SearchResults& results) {
+    // A new snapshot invalidates everything cached for the previous one
+    if (generation != m_cacheGeneration) {
+        ClearCache();
+        m_cacheGeneration = generation;
+        return false;
+    }
+
+    for (CachedResults& cached : m_cache) {
+        if (cached.query == foldedQuery) {
+            cached.lastUse = ++m_cacheClock;
+            results = cached.results;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SearchEngine::StoreInCache(const std::wstring& foldedQuery, uint64_t generation, const SearchResults& results) {
+    if (m_cacheCapacity == 0 || generation != m_cacheGeneration) return;
+
+    CachedResults* slot = nullptr;
+    if (m_cache.size() < m_cacheCapacity) {
+        slot = &m_cache.emplace_back();
+    } else {
+        // Reuse the least recently used entry, and its buffers
+        slot = &*std::min_element(m_cache.begin(), m_cache.end(),
+                                  [](const CachedResults& a, const CachedResults& b) { return a.lastUse < b.lastUse; });
+    }
+    // Slots are recycled in no particular order; sizing them all for the
+    // largest result lets the cache reach a steady state without allocating
+    m_cacheSlotSize = std::max(m_cacheSlotSize, results.Size());
+    slot->results.Reserve(m_cacheSlotSize);
+    slot->query.reserve(std::max<size_t>(foldedQuery.size(), 32));
+    slot->query = foldedQuery;
+    slot->results = results;
+    slot->lastUse = ++m_cacheClock;
+}
+
+template <typename Policy>
+bool SearchEngine::ScoreSequential(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer,
+                                   SearchResults& results) {
+    for (size_t i = 0; i < m_candidates.size(); ++i) {
+        if ((i & 255) == 0 && Cancelled()) return false;
+
+        const size_t entry = m_candidates[i];
+        EntryBound& bound = m_bounds[entry];
+        bound.epoch = m_boundEpoch;
+        double finalScore = ScoreEntry(corpus, entry, scorer, &bound);
+
+        // Use a threshold for quality results
+        if (finalScore > BasicSearchScorer<Policy>::kMatchThreshold) {
+            if (m_rankBoost) finalScore += m_rankBoost(entry);
+            results.Add(static_cast<uint32_t>(entry), finalScore);
+        }
+    }
+    return true;
+}
+
+template <typename Policy>
+bool SearchEngine::ScoreParallel(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer, size_t rankHint,
+                                 SearchResults& results) {
+    if (!m_pool) {
+        m_pool = std::make_unique<SearchWorkerPool>(m_workerCount);
+    }
+
+    // Fixed contiguous chunks, one per thread, so the split depends only on
+    // the candidate count and never on scheduling
+    const size_t chunks = m_pool->Concurrency();
+    const size_t perChunk = (m_candidates.size() + chunks - 1) / chunks;
+    m_chunkMatches.resize(chunks);
+
+    // Captures a single pointer so that std::function stores it inline
+    struct Pass {
+        SearchEngine* engine;
+        const SearchCorpus* corpus;
+        const BasicSearchScorer<Policy>* scorer;
+        size_t perChunk;
+        size_t rankHint;
+    };
+    const Pass pass{ this, &corpus, &scorer, perChunk, rankHint };
+    const std::function<void(size_t)> task = [p = &pass](size_t chunk) {
+        SearchEngine& engine = *p->engine;
+        const size_t begin = std::min(chunk * p->perChunk, engine.m_candidates.size());
+        const size_t end = std::min(begin + p->perChunk, engine.m_candidates.size());
+        engine.ScoreChunk(*p->corpus, *p->scorer, begin, end, p->rankHint,
+                          engine.m_chunkMatches[chunk]);
+    };
+    m_pool->Run(chunks, task);
+    if (Cancelled()) return false;
+
+    size_t total = 0;
+    for (const auto& matches : m_chunkMatches) {
+        total += matches.size();
+    }
+    results.Reserve(total);
+
+    // Merge the per-chunk top-K lists into the global top-K. RanksBefore is
+    // a strict total order, so the outcome does not depend on the split.
+    std::vector<size_t>& heads = m_mergeHeads;
+    heads.assign(chunks, 0);
+    size_t ranked = 0;
+    while (ranked < rankHint) {
+        size_t best = chunks;
+        for (size_t t = 0; t < chunks; ++t) {
+            const auto& matches = m_chunkMatches[t];
+            if (heads[t] >= std::min(rankHint, matches.size())) continue;
+            if (best == chunks || RanksBefore(matches[heads[t]], m_chunkMatches[best][heads[best]])) {
+                best = t;
+            }
+        }
+        if (best == chunks) break;
+        const SearchMatch& match = m_chunkMatches[best][heads[best]++];
+        results.Add(match.entry, match.score);
+        ++ranked;
+    }
+
+    // Everything else is the lazily ranked tail
+    for (size_t t = 0; t < chunks; ++t) {
+        const auto& matches = m_chunkMatches[t];
+        for (size_t i = heads[t]; i < matches.size(); ++i) {
+            results.Add(matches[i].entry, matches[i].score);
+        }
+    }
+    results.AssumeRanked(ranked);
+    return true;
+}
+
+template <typename Policy>
+void SearchEngine::ScoreChunk(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer, size_t begin,
+                              size_t end, size_t rankHint, std::vector<SearchMatch>& matches) {
+    matches.clear();
+    for (size_t i = begin; i < end; ++i) {
+        if (((i - begin) & 255) == 0 && Cancelled()) return;
+        // Candidates are distinct, so each chunk writes its own bounds
+        const size_t entry = m_candidates[i];
+        EntryBound& bound = m_bounds[entry];
+        bound.epoch = m_boundEpoch;
+        double finalScore = ScoreEntry(corpus, entry, scorer, &bound);
+        if (finalScore > BasicSearchScorer<Policy>::kMatchThreshold) {
+            if (m_rankBoost) finalScore += m_rankBoost(entry);
+            matches.push_back({ static_cast<uint32_t>(entry), finalScore });
+        }
+    }
+
+    // Each chunk brings its own top-K to the merge
+    const size_t top = std::min(rankHint, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + top, matches.end(), RanksBefore);
+}
+
+template <typename Policy>
+void SearchEngine::VerifyPrefilter(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer,
+                                   std::pmr::memory_resource* scratch) {
+    // Score every entry the prefilter or narrowing rejected; none of them
+    // may pass.
+    std::pmr::vector<bool> kept(corpus.Size(), false, scratch);
+    for (size_t entry : m_candidates) {
+        kept[entry] = true;
+    }
+
+    for (size_t entry = 0; entry < corpus.Size(); ++entry) {
+        if (kept[entry]) continue;
+        double finalScore = ScoreEntry(corpus, entry, scorer, nullptr);
+        if (finalScore > BasicSearchScorer<Policy>::kMatchThreshold && m_onPrefilterMiss) {
+            m_onPrefilterMiss(corpus, entry, finalScore);
+        }
+    }
+}
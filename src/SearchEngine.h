@@ -0,0 +1,138 @@
+#pragma once
+
+#include "ScratchArena.h"
+#include "SearchCorpus.h"
+#include "SearchResults.h"
+#include "SearchScorer.h"
+#include "SearchWorkerPool.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The filtering pipeline behind the switcher's search box, independent of
+// Win32: prefilter, score, threshold and rank one corpus against a query.
+// Remembers what each scored entry's score implies for longer queries, so
+// that typing further skips entries that provably cannot match, and scores
+// on a worker pool when the candidate set is large. Recent results are
+// cached per query for the current snapshot, so backspace and retyping do
+// not rescore. Per-pass temporaries come from a scratch arena and all other
+// buffers are reused, so a steady stream of keystrokes does not allocate.
+// One engine serves one filtering context (not thread-safe).
+class SearchEngine {
+public:
+    // Called for every prefilter reject that would have passed (verification only)
+    using PrefilterMissHandler = std::function<void(const SearchCorpus& corpus, size_t entry, double score)>;
+    // Added to the score of every match before ranking; may run on worker threads
+    using RankBoost = std::function<double(size_t entry)>;
+
+    SearchEngine();
+    ~SearchEngine();
+
+    // Score on the worker pool once this many candidates survive the
+    // prefilter; 0 keeps scoring on the calling thread.
+    void SetParallelThreshold(size_t candidates) { m_parallelThreshold = candidates; }
+    // Threads used for parallel scoring, including the caller; 0 = all cores
+    void SetWorkerCount(size_t threads);
+
+    // Ranks matches by score + boost(entry). The match threshold still
+    // applies to the plain score, so a boost never makes a window match.
+    void SetRankBoost(RankBoost boost) { m_rankBoost = std::move(boost); }
+
+    // Number of queries whose results are kept for the current snapshot; 0 disables
+    void SetCacheCapacity(size_t queries);
+    // Drops cached results, e.g. when ranking inputs other than the corpus change
+    void ClearCache();
+
+    // Scoring policy for the following passes; drops cached results
+    void SetScoringPreset(ScoringPreset preset);
+    ScoringPreset Preset() const { return m_preset; }
+
+    // Also score prefilter and narrowing rejects and report any that would have passed
+    void SetVerifyPrefilter(bool verify, PrefilterMissHandler onMiss = nullptr);
+
+    // Scoring gives up soon after `cancel` becomes true (nullptr = never)
+    void SetCancelFlag(const std::atomic<bool>* cancel) { m_cancel = cancel; }
+
+    // Filters `corpus`, identified by `generation`, with an already folded
+    // query. At least the first `rankHint` results come back ranked.
+    // Returns false if the pass was cancelled; `results` is then incomplete
+    // and the engine's state is as if the pass never ran.
+    bool Filter(const SearchCorpus& corpus, uint64_t generation, const std::wstring& foldedQuery,
+                size_t rankHint, SearchResults& results);
+
+    // Forgets the previous queries, forcing the next pass to score everything
+    void Reset();
+
+private:
+    // What the passes since the query last shrank or changed learned about
+    // one entry, valid while `epoch` is m_boundEpoch
+    struct EntryBound {
+        uint64_t epoch = 0;
+        size_t queryLength = 0; // The bounds are for this prefix of m_boundQuery
+        TargetBound title;
+        TargetBound process;
+        double acronym = 0.0;
+    };
+
+    // One instantiation per scoring preset; Filter() picks one per pass
+    template <typename Policy>
+    bool FilterWith(const SearchCorpus& corpus, uint64_t generation, const std::wstring& foldedQuery,
+                    size_t rankHint, SearchResults& results);
+    template <typename Policy>
+    static double ScoreEntry(const SearchCorpus& corpus, size_t entry, const BasicSearchScorer<Policy>& scorer,
+                             EntryBound* bound);
+    template <typename Policy>
+    bool ScoreSequential(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer, SearchResults& results);
+    template <typename Policy>
+    bool ScoreParallel(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer, size_t rankHint,
+                       SearchResults& results);
+    template <typename Policy>
+    void ScoreChunk(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer, size_t begin, size_t end,
+                    size_t rankHint, std::vector<SearchMatch>& matches);
+    template <typename Policy>
+    void VerifyPrefilter(const SearchCorpus& corpus, const BasicSearchScorer<Policy>& scorer,
+                         std::pmr::memory_resource* scratch);
+    bool Cancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+    bool LookupCache(const std::wstring& foldedQuery, uint64_t generation, SearchResults& results);
+    void StoreInCache(const std::wstring& foldedQuery, uint64_t generation, const SearchResults& results);
+
+    // Incremental narrowing: per corpus entry, for prefixes of the last query scored
+    std::vector<EntryBound> m_bounds;
+    std::wstring m_boundQuery;
+    uint64_t m_boundGeneration = 0;
+    uint64_t m_boundEpoch = 0;
+
+    // Least recently used results, all for m_cacheGeneration
+    struct CachedResults {
+        std::wstring query;
+        SearchResults results;
+        uint64_t lastUse = 0;
+    };
+    std::vector<CachedResults> m_cache;
+    size_t m_cacheCapacity = 16;
+    uint64_t m_cacheGeneration = 0;
+    uint64_t m_cacheClock = 0;
+    size_t m_cacheSlotSize = 0; // Largest cached result, every slot is sized for it
+
+    // Per-pass scratch: temporaries from the arena, plus buffers kept to
+    // reuse their capacity
+    ScratchArena m_scratch;
+    std::vector<size_t> m_candidates;
+    std::vector<std::vector<SearchMatch>> m_chunkMatches;
+    std::vector<size_t> m_mergeHeads;
+
+    size_t m_parallelThreshold = 0;
+    size_t m_workerCount = 0;
+    std::unique_ptr<SearchWorkerPool> m_pool;
+
+    ScoringPreset m_preset = ScoringPreset::Balanced;
+    RankBoost m_rankBoost;
+    const std::atomic<bool>* m_cancel = nullptr;
+
+    bool m_verifyPrefilter = false;
+    PrefilterMissHandler m_onPrefilterMiss;
+};
@@ -0,0 +1,40 @@
+#include "SearchResults.h"
+#include <algorithm>
+
+void SearchResults::Clear() {
+    m_matches.clear();
+    m_ranked = 0;
+}
+
+void SearchResults::AssignAll(size_t count) {
+    m_matches.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        m_matches[i] = { static_cast<uint32_t>(i), 0.0 };
+    }
+    m_ranked = count; // Equal scores, already in corpus order
+}
+
+void SearchResults::EnsureRanked(size_t count) {
+    if (count <= m_ranked) return;
+
+    // Rank a little ahead so single steps past the page don't re-sort the tail
+    count = std::min(std::max(count, m_ranked + kRankChunk), m_matches.size());
+    std::partial_sort(m_matches.begin() + m_ranked, m_matches.begin() + count,
+                      m_matches.end(), RanksBefore);
+    m_ranked = count;
+}
+
+const SearchMatch& SearchResults::At(size_t rank) {
+    EnsureRanked(rank + 1);
+    return m_matches[rank];
+}
+
+size_t SearchResults::RankOf(uint32_t entry) const {
+    auto it = std::find_if(m_matches.begin(), m_matches.end(),
+                           [entry](const SearchMatch& match) { return match.entry == entry; });
+    if (it == m_matches.end()) {
+        return m_matches.size();
+    }
+    return static_cast<size_t>(std::count_if(m_matches.begin(), m_matches.end(),
+                                             [&](const SearchMatch& other) { return RanksBefore(other, *it); }));
+}
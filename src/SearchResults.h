@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One matching corpus entry and its final score.
+struct SearchMatch {
+    uint32_t entry;
+    double score;
+};
+
+// Higher score first; ties keep corpus order so the ranking is deterministic.
+inline bool RanksBefore(const SearchMatch& a, const SearchMatch& b) {
+    return a.score > b.score || (a.score == b.score && a.entry < b.entry);
+}
+
+// Matches of one filter pass, ranked lazily. Only the prefix that is
+// actually displayed gets sorted (partial_sort); scrolling or paging past it
+// extends the ranked prefix on demand.
+class SearchResults {
+public:
+    void Clear();
+    void Reserve(size_t count) { m_matches.reserve(count); }
+    void Add(uint32_t entry, double score) { m_matches.push_back({ entry, score }); }
+
+    // Every entry of a corpus of `count` entries, in corpus order
+    void AssignAll(size_t count);
+
+    // For producers that already placed the best `count` matches at the
+    // front in rank order (e.g. a merge of per-thread top-K lists)
+    void AssumeRanked(size_t count) { m_ranked = count < m_matches.size() ? count : m_matches.size(); }
+
+    size_t Size() const { return m_matches.size(); }
+    bool Empty() const { return m_matches.empty(); }
+
+    // Makes sure the best `count` matches are at the front, in rank order
+    void EnsureRanked(size_t count);
+
+    // Match at `rank`, ranking further if needed
+    const SearchMatch& At(size_t rank);
+
+    // Rank the given entry would have, or Size() if it is not a match
+    size_t RankOf(uint32_t entry) const;
+
+    // Unranked view, in no particular order past RankedCount()
+    const std::vector<SearchMatch>& Matches() const { return m_matches; }
+    size_t RankedCount() const { return m_ranked; }
+
+private:
+    static constexpr size_t kRankChunk = 32;
+
+    std::vector<SearchMatch> m_matches;
+    size_t m_ranked = 0;
+};
@@ -0,0 +1,348 @@
+#include "SearchScorer.h"
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+
+namespace {
+    template <typename Policy>
+    constexpr bool kFuzzy = Policy::kFuzzyWeight > 0.0;
+    template <typename Policy>
+    constexpr bool kPrefix = Policy::kPrefixWeight > 0.0;
+    // The greedy cursor feeds both the position and the sequential score
+    template <typename Policy>
+    constexpr bool kCursor = Policy::kPositionWeight > 0.0 || Policy::kSequentialWeight > 0.0;
+}
+
+bool ParseScoringPreset(const std::wstring& name, ScoringPreset& preset) {
+    if (name == L"balanced") {
+        preset = ScoringPreset::Balanced;
+    } else if (name == L"title-only") {
+        preset = ScoringPreset::TitleOnly;
+    } else if (name == L"process-first") {
+        preset = ScoringPreset::ProcessFirst;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <typename Policy>
+BasicSearchScorer<Policy>::BasicSearchScorer(const std::wstring& foldedQuery, std::pmr::memory_resource* memory)
+    : m_query(foldedQuery.data(), foldedQuery.size(), memory)
+    , m_pattern(foldedQuery, memory) {
+}
+
+template <typename Policy>
+MatchComponents BasicSearchScorer<Policy>::ScoreComponents(const wchar_t* text, size_t length,
+                                                           WordStarts words) const {
+    MatchComponents result;
+    const size_t m = m_query.size();
+    const size_t n = length;
+    if (m == 0 || n == 0) {
+        result.fuzzy = (m == 0 && n == 0) ? 100.0 : 0.0;
+        return result;
+    }
+
+    const wchar_t* query = m_query.data();
+    const bool singleWord = m_pattern.Blocks() == 1;
+    const uint64_t last = uint64_t(1) << ((m - 1) % 64);
+
+    // Edit distance (Myers/Hyyro), see EditDistancePattern
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+    size_t distance = m;
+
+    // Shift-and state: bit i set when query[0..i] ends here and started at
+    // the beginning, after whitespace or at a word start
+    uint64_t active = 0;
+    size_t nextWord = 0;
+    bool exactPrefix = false;
+    bool wordStart = false;
+
+    // Leading characters shared with the query
+    size_t leading = 0;
+
+    // Greedy in-order cursor shared by the position and sequential scores
+    size_t cursor = 0;
+    size_t currentRun = 0;
+    size_t longestRun = 0;
+    size_t lastFound = 0;
+    double positionSum = 0.0;
+
+    for (size_t j = 0; j < n; ++j) {
+        const wchar_t c = text[j];
+
+        if ((kFuzzy<Policy> || kPrefix<Policy>) && singleWord) {
+            const uint64_t eq = m_pattern.Mask(0, c);
+
+            if constexpr (kFuzzy<Policy>) {
+                const uint64_t xv = eq | mv;
+                const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                uint64_t ph = mv | ~(xh | pv);
+                uint64_t mh = pv & xh;
+                if (ph & last) {
+                    ++distance;
+                } else if (mh & last) {
+                    --distance;
+                }
+                ph = (ph << 1) | 1;
+                mh = mh << 1;
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
+            }
+
+            if constexpr (kPrefix<Policy>) {
+                // Word starts skip punctuation ("(3) Inbox"), so the beginning
+                // and whitespace are checked as well
+                uint64_t inject = (j == 0 || WordBoundaries::IsSpace(text[j - 1])) ? 1 : 0;
+                if (nextWord < words.count && words.offsets[nextWord] == j) {
+                    inject = 1;
+                    ++nextWord;
+                }
+                active = ((active << 1) | inject) & eq;
+                if (active & last) {
+                    if (j + 1 == m) {
+                        exactPrefix = true;
+                    } else {
+                        wordStart = true;
+                    }
+                }
+            }
+        }
+
+        if (kPrefix<Policy> && leading == j && leading < m && query[leading] == c) {
+            ++leading;
+        }
+
+        if (kCursor<Policy> && cursor < m) {
+            if (query[cursor] == c) {
+                positionSum += 1.0 - (static_cast<double>(j) / n);
+                lastFound = j + 1;
+                ++cursor;
+                ++currentRun;
+                longestRun = std::max(longestRun, currentRun);
+            } else {
+                currentRun = 0;
+            }
+        }
+    }
+
+    // Fuzzy
+    if constexpr (kFuzzy<Policy>) {
+        if (!singleWord) {
+            distance = m_pattern.Distance(text, n);
+        }
+        const double maxLen = static_cast<double>(std::max(m, n));
+        result.fuzzy = (1.0 - static_cast<double>(distance) / maxLen) * 100.0;
+    }
+
+    // Position: the greedy cursor found query[0..cursor); any character it
+    // stopped at is missing, and the ones after it are searched again from
+    // the last hit onwards
+    if constexpr (Policy::kPositionWeight > 0.0) {
+        double positionPenalty = 0.0;
+        for (size_t i = cursor; i < m; ++i) {
+            const wchar_t* hit = lastFound < n ? std::wmemchr(text + lastFound, query[i], n - lastFound) : nullptr;
+            if (hit) {
+                const size_t foundPos = static_cast<size_t>(hit - text);
+                positionSum += 1.0 - (static_cast<double>(foundPos) / n);
+                lastFound = foundPos + 1;
+            } else {
+                positionPenalty += 0.2;
+            }
+        }
+        result.position = (positionSum / m) * 100.0;
+        result.position = std::max(0.0, result.position - (positionPenalty * 100.0));
+    }
+
+    // Prefix
+    if constexpr (kPrefix<Policy>) {
+        if (!singleWord) {
+            result.prefix = PrefixFallback(text, n, words, leading);
+        } else if (exactPrefix) {
+            result.prefix = 100.0;
+        } else if (wordStart) {
+            result.prefix = 80.0;
+        } else if (leading > 0) {
+            result.prefix = (static_cast<double>(leading) / m) * 60.0;
+        }
+    }
+
+    // Sequential
+    if (Policy::kSequentialWeight > 0.0 && cursor > 0) {
+        double matchRatio = static_cast<double>(cursor) / m;
+        double consecutiveBonus = static_cast<double>(longestRun) / m;
+        result.sequential = (matchRatio * 60.0) + (consecutiveBonus * 40.0);
+    }
+
+    return result;
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::PrefixFallback(const wchar_t* text, size_t length, WordStarts words,
+                                                 size_t leading) const {
+    // Queries longer than one machine word: compare in place wherever the
+    // shift-and matcher would start one, the beginning, after whitespace
+    // and at each word start
+    const size_t m = m_query.size();
+    if (length < m) {
+        return leading > 0 ? (static_cast<double>(leading) / m) * 60.0 : 0.0;
+    }
+    if (std::wmemcmp(text, m_query.data(), m) == 0) {
+        return 100.0;
+    }
+    size_t w = 0;
+    for (size_t j = 1; j + m <= length; ++j) {
+        while (w < words.count && words.offsets[w] < j) ++w;
+        const bool start = (w < words.count && words.offsets[w] == j) || WordBoundaries::IsSpace(text[j - 1]);
+        if (start && text[j] == m_query[0] && std::wmemcmp(text + j, m_query.data(), m) == 0) {
+            return 80.0;
+        }
+    }
+    return leading > 0 ? (static_cast<double>(leading) / m) * 60.0 : 0.0;
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::ScoreTarget(const wchar_t* text, size_t length, WordStarts words) const {
+    const MatchComponents c = ScoreComponents(text, length, words);
+    return (c.fuzzy * Policy::kFuzzyWeight) +
+           (c.position * Policy::kPositionWeight) +
+           (c.prefix * Policy::kPrefixWeight) +
+           (c.sequential * Policy::kSequentialWeight);
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::ScoreTarget(const wchar_t* text, size_t length, WordStarts words,
+                                             TargetBound& bound) const {
+    const MatchComponents c = ScoreComponents(text, length, words);
+    const size_t m = m_query.size();
+    const double maxLen = static_cast<double>(std::max(m, length));
+    bound.distance = kFuzzy<Policy> ? static_cast<uint32_t>(std::lround((1.0 - c.fuzzy / 100.0) * maxLen)) : 0;
+    bound.rest = static_cast<double>(m) * ((c.position * Policy::kPositionWeight) +
+                                           (c.prefix * Policy::kPrefixWeight) +
+                                           (c.sequential * Policy::kSequentialWeight));
+    return (c.fuzzy * Policy::kFuzzyWeight) +
+           (c.position * Policy::kPositionWeight) +
+           (c.prefix * Policy::kPrefixWeight) +
+           (c.sequential * Policy::kSequentialWeight);
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::AcronymScore(const wchar_t* text, WordStarts words) const {
+    const size_t m = m_query.size();
+    if (m < 2 || words.count < m) return 0.0;
+
+    // Greedy: the earliest word for each initial
+    size_t matched = 0;
+    size_t first = 0;
+    size_t previous = 0;
+    size_t skipped = 0;
+    for (size_t w = 0; w < words.count && matched < m; ++w) {
+        if (text[words.offsets[w]] != m_query[matched]) continue;
+        if (matched == 0) {
+            first = w;
+        } else {
+            skipped += w - previous - 1;
+        }
+        previous = w;
+        ++matched;
+    }
+    if (matched < m) return 0.0;
+
+    // Words skipped between initials hurt much more than words before them
+    // ("main.cpp - Visual Studio Code" is still a clean "vsc"); words after
+    // them only break ties
+    const size_t trailing = words.count - previous - 1;
+    const double score = 90.0 - static_cast<double>(skipped) * 8.0 - static_cast<double>(first) * 2.0 -
+                         static_cast<double>(std::min<size_t>(trailing, 4)) * 0.5;
+    return std::max(0.0, score);
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::CombineScores(double titleScore, double processScore) {
+    // Take the better score, but give a small bonus if process name matches well
+    double finalScore = std::max(titleScore * Policy::kTitleFactor, processScore);
+
+    // Bonus if process name has a good match (helps with app-specific searches)
+    if (processScore > Policy::kProcessBonusAbove) {
+        finalScore += Policy::kProcessBonus;
+    }
+    return finalScore;
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::UpperBoundWithMissing(size_t queryLength, size_t missing) {
+    if (queryLength == 0) return 0.0;
+    const double m = static_cast<double>(queryLength);
+    const double k = static_cast<double>(std::min(missing, queryLength));
+    const double present = (m - k) / m;
+
+    // Each missing character costs at least one edit, and the length gap
+    // costs the rest, so the ratio peaks at m / (m + k).
+    const double fuzzy = 100.0 * m / (m + k);
+    // Missing characters are never found and each one is penalised.
+    const double position = std::max(0.0, present * 100.0 - k * 20.0);
+    // No exact, word-start or acronym hit is possible, only leading characters.
+    const double prefix = present * 60.0;
+    const double sequential = present * 100.0;
+
+    const double target = (fuzzy * Policy::kFuzzyWeight) +
+                          (position * Policy::kPositionWeight) +
+                          (prefix * Policy::kPrefixWeight) +
+                          (sequential * Policy::kSequentialWeight);
+    return CombineScores(target, Policy::kScoreProcess ? target : 0.0);
+}
+
+template <typename Policy>
+bool BasicSearchScorer<Policy>::MayMatchWithMissing(size_t queryLength, size_t missing) {
+    // The margin keeps rounding in the real scorer from ever beating the bound
+    return UpperBoundWithMissing(queryLength, missing) >= kMatchThreshold - 1e-6;
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::ExtendedTargetBound(size_t queryLength, size_t added, const TargetBound& bound,
+                                                      size_t length) {
+    if (length == 0) return 0.0;
+    const size_t extended = queryLength + added;
+
+    // Each added character can undo at most one edit
+    double fuzzy = 0.0;
+    if constexpr (kFuzzy<Policy>) {
+        const size_t distance = bound.distance > added ? bound.distance - added : 0;
+        fuzzy = (1.0 - static_cast<double>(distance) / static_cast<double>(std::max(extended, length))) * 100.0;
+    }
+
+    // The greedy cursor, the leading characters and the prefix matcher see
+    // the first queryLength characters exactly as before
+    constexpr double kRestWeight = Policy::kPositionWeight + Policy::kPrefixWeight + Policy::kSequentialWeight;
+    const double rest = std::min(kRestWeight * 100.0,
+                                 (bound.rest + static_cast<double>(added) * kRestWeight * 100.0) /
+                                     static_cast<double>(extended));
+    return (fuzzy * Policy::kFuzzyWeight) + rest;
+}
+
+template <typename Policy>
+double BasicSearchScorer<Policy>::ExtendedBound(size_t queryLength, size_t added, const TargetBound& title,
+                                                size_t titleLength, double acronymScore, const TargetBound& process,
+                                                size_t processLength) {
+    double titleBound = ExtendedTargetBound(queryLength, added, title, titleLength);
+    if constexpr (Policy::kAcronyms) {
+        // One character is never an acronym, two may be
+        titleBound = std::max(titleBound, queryLength < 2 ? 90.0 : acronymScore + 2.0);
+    }
+    double processBound = 0.0;
+    if constexpr (Policy::kScoreProcess) {
+        processBound = ExtendedTargetBound(queryLength, added, process, processLength);
+    }
+    return CombineScores(titleBound, processBound);
+}
+
+template <typename Policy>
+bool BasicSearchScorer<Policy>::MayMatchExtended(double extendedBound) {
+    // Same margin as MayMatchWithMissing
+    return extendedBound >= kMatchThreshold - 1e-6;
+}
+
+template class BasicSearchScorer<BalancedScoring>;
+template class BasicSearchScorer<TitleOnlyScoring>;
+template class BasicSearchScorer<ProcessFirstScoring>;
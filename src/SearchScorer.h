@@ -0,0 +1,126 @@
+#pragma once
+
+#include "EditDistance.h"
+#include "WordStarts.h"
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// The four fuzzy-matching components, each on a 0..100 scale.
+struct MatchComponents {
+    double fuzzy = 0.0;      // Levenshtein ratio
+    double position = 0.0;   // How early the query characters appear
+    double prefix = 0.0;     // Exact prefix, word-start or leading-character match
+    double sequential = 0.0; // Greedy in-order matches and longest run
+};
+
+// What scoring one target against a query implies for every longer query
+// that starts with it, see BasicSearchScorer::ExtendedBound().
+struct TargetBound {
+    uint32_t distance = 0; // Edit distance between query and target
+    double rest = 0.0;     // Query length times the weighted position, prefix and sequential scores
+};
+
+// Scoring presets. Each policy fixes the component weights, how title and
+// process-name scores combine and the match threshold at compile time; a
+// component with weight 0 (or a target that is not scored) is compiled out
+// of the scorer and the filter loop instead of being skipped at run time.
+enum class ScoringPreset {
+    Balanced,     // Title and process name, the classic weights
+    TitleOnly,    // Ignores process names entirely
+    ProcessFirst, // Favours windows whose process name matches
+};
+
+// Parses "balanced", "title-only" or "process-first"; false if unknown
+bool ParseScoringPreset(const std::wstring& name, ScoringPreset& preset);
+
+struct BalancedScoring {
+    static constexpr double kFuzzyWeight = 0.3;
+    static constexpr double kPositionWeight = 0.2;
+    static constexpr double kPrefixWeight = 0.3;
+    static constexpr double kSequentialWeight = 0.2;
+    static constexpr bool kAcronyms = true;          // Title initials ("vsc")
+    static constexpr bool kScoreProcess = true;
+    static constexpr double kTitleFactor = 1.0;
+    static constexpr double kProcessBonusAbove = 70.0; // Process scores above this...
+    static constexpr double kProcessBonus = 10.0;      // ...add this to the final score
+    static constexpr double kMatchThreshold = 60.0;    // Final scores must exceed this
+};
+
+struct TitleOnlyScoring : BalancedScoring {
+    static constexpr bool kScoreProcess = false;
+    static constexpr double kProcessBonus = 0.0;
+};
+
+struct ProcessFirstScoring : BalancedScoring {
+    static constexpr double kTitleFactor = 0.9;
+    static constexpr double kProcessBonusAbove = 60.0;
+    static constexpr double kProcessBonus = 15.0;
+};
+
+// Scores targets against one query. All components are produced by a single
+// forward scan of the target: the edit distance columns, a shift-and matcher
+// for prefix/word-start hits and the greedy in-order cursor share the loop.
+// Only query characters that never occur after the cursor cost a rescan of
+// the remaining tail. Word starts come precomputed with the target (see
+// SearchCorpus). Platform neutral; expects already folded input.
+template <typename Policy>
+class BasicSearchScorer {
+public:
+    // Windows must score strictly above this to be listed.
+    static constexpr double kMatchThreshold = Policy::kMatchThreshold;
+
+    // The scorer's own storage comes from `memory`; scoring allocates nothing
+    explicit BasicSearchScorer(const std::wstring& foldedQuery,
+                               std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+    // Disabled components stay 0
+    MatchComponents ScoreComponents(const wchar_t* text, size_t length, WordStarts words) const;
+
+    // Weighted blend of the components for one target.
+    double ScoreTarget(const wchar_t* text, size_t length, WordStarts words) const;
+    // Same, also recording what the score implies for longer queries
+    double ScoreTarget(const wchar_t* text, size_t length, WordStarts words, TargetBound& bound) const;
+
+    // Score of the query as the initials of words in order ("vsc" for
+    // "Visual Studio Code"), lower for skipped words; 0 if it is not one.
+    // O(words), on the final score scale.
+    double AcronymScore(const wchar_t* text, WordStarts words) const;
+
+    // Final window score from the title and process-name scores.
+    static double CombineScores(double titleScore, double processScore);
+
+    // Highest final score a window can reach when `missing` of the
+    // `queryLength` query characters (counted with repeats) do not occur in
+    // its title or process name at all.
+    static double UpperBoundWithMissing(size_t queryLength, size_t missing);
+    // Whether such a window may still pass the threshold
+    static bool MayMatchWithMissing(size_t queryLength, size_t missing);
+
+    // Highest final score a window can reach for any query that extends a
+    // `queryLength` query by `added` characters, given that query's title
+    // and process bounds and acronym score. Every query character adds at
+    // most 100 to the query length times the position, prefix and
+    // sequential scores, and removes at most one edit; an acronym can only
+    // lose skipped words or gain the few points of its trailing words.
+    static double ExtendedBound(size_t queryLength, size_t added, const TargetBound& title, size_t titleLength,
+                                double acronymScore, const TargetBound& process, size_t processLength);
+    // Whether such a window may still pass the threshold
+    static bool MayMatchExtended(double extendedBound);
+
+    const std::pmr::wstring& Query() const { return m_query; }
+
+private:
+    double PrefixFallback(const wchar_t* text, size_t length, WordStarts words, size_t leading) const;
+    static double ExtendedTargetBound(size_t queryLength, size_t added, const TargetBound& bound, size_t length);
+
+    std::pmr::wstring m_query;
+    EditDistancePattern m_pattern;
+};
+
+// The presets are instantiated in SearchScorer.cpp
+extern template class BasicSearchScorer<BalancedScoring>;
+extern template class BasicSearchScorer<TitleOnlyScoring>;
+extern template class BasicSearchScorer<ProcessFirstScoring>;
+
+using SearchScorer = BasicSearchScorer<BalancedScoring>;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "SearchCorpus.h"
+#include <cstdint>
+#include <vector>
+
+// The platform-neutral part of a published window list: what filtering
+// needs. Immutable once published.
+struct SearchSnapshot {
+    SearchCorpus corpus;
+    std::vector<uint64_t> frecencyKeys; // FrecencyStore::WindowKey per source window
+    uint64_t generation = 0;
+};
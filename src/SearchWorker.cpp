@@ -0,0 +1,141 @@
+#include "SearchWorker.h"
+
+SearchWorker::SearchWorker(SnapshotSource source, ReadyHandler onReady)
+    : m_source(std::move(source)), m_onReady(std::move(onReady)) {
+}
+
+SearchWorker::~SearchWorker() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cancel.store(true);
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void SearchWorker::Start() {
+    m_engine.SetCancelFlag(&m_cancel);
+    if (m_frecency) {
+        m_engine.SetRankBoost([this](size_t entry) {
+            const SearchSnapshot& snapshot = *m_passSnapshot;
+            return m_frecency->Boost(snapshot.frecencyKeys[snapshot.corpus.Source(entry)], m_passQueryKey, m_passNow);
+        });
+    }
+    m_thread = std::thread([this] { Run(); });
+}
+
+uint64_t SearchWorker::Submit(const std::wstring& foldedQuery, size_t rankHint, uint64_t avoidWindowKey) {
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++m_nextId;
+        m_pending.id = id;
+        m_pending.query = foldedQuery;
+        m_pending.rankHint = rankHint;
+        m_pending.avoidWindowKey = avoidWindowKey;
+        m_cancel.store(true, std::memory_order_relaxed); // Stale pass in flight
+    }
+    m_wake.notify_one();
+    return id;
+}
+
+bool SearchWorker::TakeResponse(Response& response) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasFinished) return false;
+    std::swap(response, m_finished);
+    m_hasFinished = false;
+    return true;
+}
+
+void SearchWorker::Post(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+}
+
+void SearchWorker::Run() {
+    std::vector<Task> tasks;
+    Request request;
+    Response response;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || !m_tasks.empty() || m_pending.id != 0; });
+            if (m_stop) return;
+
+            tasks.swap(m_tasks);
+            request.id = 0;
+            if (m_pending.id != 0) {
+                std::swap(request, m_pending);
+                m_pending.id = 0;
+                m_cancel.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        for (Task& task : tasks) {
+            task(m_engine);
+        }
+        tasks.clear();
+
+        if (request.id == 0 || !FilterPass(request, response)) {
+            continue; // Nothing to do, or superseded mid-flight
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::swap(m_finished, response);
+            m_hasFinished = true;
+        }
+        m_onReady(request.id);
+    }
+}
+
+bool SearchWorker::FilterPass(const Request& request, Response& response) {
+    response.request = request.id;
+    response.snapshot = m_source();
+    response.preselect = 0;
+    if (!response.snapshot) {
+        response.results.Clear(); // Nothing published yet
+        return true;
+    }
+
+    const SearchSnapshot& snapshot = *response.snapshot;
+    m_passSnapshot = &snapshot;
+    m_passQueryKey = FrecencyStore::QueryKey(request.query);
+    m_passNow = FrecencyStore::Now();
+
+    const bool finished = m_engine.Filter(snapshot.corpus, snapshot.generation, request.query, request.rankHint,
+                                          response.results);
+    if (finished && request.query.empty() && m_frecency) {
+        response.preselect = PreselectFrequent(snapshot, response.results, request.avoidWindowKey);
+    }
+
+    m_passSnapshot = nullptr;
+    return finished;
+}
+
+size_t SearchWorker::PreselectFrequent(const SearchSnapshot& snapshot, const SearchResults& results,
+                                       uint64_t avoidWindowKey) const {
+    // The unfiltered list stays in z-order; only the selection moves to the
+    // window picked most often lately, other than the one just left
+    size_t best = 0;
+    double bestBoost = 0.0;
+    const auto& matches = results.Matches();
+    for (size_t rank = 0; rank < matches.size(); ++rank) {
+        const uint64_t key = snapshot.frecencyKeys[snapshot.corpus.Source(matches[rank].entry)];
+        if (key == avoidWindowKey) continue;
+
+        double boost = m_frecency->Boost(key, 0, m_passNow);
+        if (boost > bestBoost) {
+            bestBoost = boost;
+            best = rank;
+        }
+    }
+    return best;
+}
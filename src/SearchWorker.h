@@ -0,0 +1,91 @@
+#pragma once
+
+#include "SearchEngine.h"
+#include "SearchSnapshot.h"
+#include "FrecencyStore.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs filter passes on a dedicated thread so that the UI never waits for
+// scoring. Every Submit() gets a request id and cancels whatever pass is
+// still running; only the newest request is ever scored. Finished passes are
+// announced through the ready handler (called on the worker thread), after
+// which TakeResponse() hands the results over.
+//
+// The engine and the frecency store belong to the worker thread once
+// Start() has been called; touch them only through Post().
+class SearchWorker {
+public:
+    struct Response {
+        uint64_t request = 0;
+        std::shared_ptr<const SearchSnapshot> snapshot; // What `results` index into
+        SearchResults results;
+        size_t preselect = 0; // Rank to select first
+    };
+
+    // Returns the latest published snapshot (may be null)
+    using SnapshotSource = std::function<std::shared_ptr<const SearchSnapshot>()>;
+    using ReadyHandler = std::function<void(uint64_t request)>;
+    using Task = std::function<void(SearchEngine& engine)>;
+
+    SearchWorker(SnapshotSource source, ReadyHandler onReady);
+    ~SearchWorker();
+
+    SearchWorker(const SearchWorker&) = delete;
+    SearchWorker& operator=(const SearchWorker&) = delete;
+
+    // Configuration, before Start()
+    SearchEngine& Engine() { return m_engine; }
+    void SetFrecencyStore(FrecencyStore* store) { m_frecency = store; }
+    void Start();
+
+    // Queues a pass over the latest snapshot and returns its request id.
+    // For an empty query, the first selection skips `avoidWindowKey`.
+    uint64_t Submit(const std::wstring& foldedQuery, size_t rankHint, uint64_t avoidWindowKey = 0);
+
+    // Swaps the newest finished response into `response`; false if none is waiting
+    bool TakeResponse(Response& response);
+
+    // Runs `task` on the worker thread before the next pass
+    void Post(Task task);
+
+private:
+    struct Request {
+        uint64_t id = 0;
+        std::wstring query;
+        size_t rankHint = 0;
+        uint64_t avoidWindowKey = 0;
+    };
+
+    void Run();
+    bool FilterPass(const Request& request, Response& response);
+    size_t PreselectFrequent(const SearchSnapshot& snapshot, const SearchResults& results, uint64_t avoidWindowKey) const;
+
+    SnapshotSource m_source;
+    ReadyHandler m_onReady;
+    SearchEngine m_engine;
+    FrecencyStore* m_frecency = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    Request m_pending;            // Newest request; id 0 = none
+    uint64_t m_nextId = 0;
+    std::vector<Task> m_tasks;
+    Response m_finished;
+    bool m_hasFinished = false;
+    bool m_stop = false;
+    std::atomic<bool> m_cancel{false};
+    std::thread m_thread;
+
+    // State of the pass in flight (worker thread only)
+    const SearchSnapshot* m_passSnapshot = nullptr;
+    uint64_t m_passQueryKey = 0;
+    uint32_t m_passNow = 0;
+};
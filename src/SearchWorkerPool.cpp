@@ -0,0 +1,68 @@
+#include "SearchWorkerPool.h"
+
+SearchWorkerPool::SearchWorkerPool(size_t concurrency) {
+    if (concurrency == 0) {
+        concurrency = std::thread::hardware_concurrency();
+    }
+    for (size_t i = 1; i < concurrency; ++i) {
+        m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+SearchWorkerPool::~SearchWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void SearchWorkerPool::Run(size_t taskCount, const std::function<void(size_t)>& task) {
+    if (taskCount == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask.store(0, std::memory_order_relaxed);
+        m_busyWorkers = m_workers.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    Drain(); // The calling thread works too
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_task = nullptr;
+}
+
+void SearchWorkerPool::WorkerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        Drain();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0) {
+            m_idle.notify_one();
+        }
+    }
+}
+
+void SearchWorkerPool::Drain() {
+    for (;;) {
+        size_t index = m_nextTask.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_taskCount) break;
+        (*m_task)(index);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel scoring. Run() hands out
+// task indices to the workers and the calling thread and returns once every
+// task has finished. Not reentrant: one Run() at a time.
+class SearchWorkerPool {
+public:
+    // `concurrency` counts the calling thread; 0 picks the hardware count.
+    explicit SearchWorkerPool(size_t concurrency);
+    ~SearchWorkerPool();
+
+    SearchWorkerPool(const SearchWorkerPool&) = delete;
+    SearchWorkerPool& operator=(const SearchWorkerPool&) = delete;
+
+    size_t Concurrency() const { return m_workers.size() + 1; }
+
+    void Run(size_t taskCount, const std::function<void(size_t)>& task);
+
+private:
+    void WorkerLoop();
+    void Drain();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+
+    const std::function<void(size_t)>* m_task = nullptr;
+    size_t m_taskCount = 0;
+    std::atomic<size_t> m_nextTask{0};
+    size_t m_busyWorkers = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Hands immutable snapshots from one writer to any number of readers,
+// read-copy-update style. The writer builds a new snapshot off to the side
+// and publishes it with one atomic pointer store; readers pin whichever
+// snapshot is current with one atomic load and keep it alive for as long
+// as they use it. The old snapshot is freed when its last reader lets go,
+// so neither side ever waits for the other to finish with one.
+//
+// Snapshot must carry a `generation` that the writer increases with every
+// publish; Generation() lets a reader see that nothing new arrived without
+// pinning anything.
+template <typename Snapshot>
+class SnapshotPublisher {
+public:
+    using Pointer = std::shared_ptr<const Snapshot>;
+
+    // The current snapshot, or null before the first publish
+    Pointer Pin() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+        return m_current.load(std::memory_order_acquire);
+#else
+        return std::atomic_load_explicit(&m_current, std::memory_order_acquire);
+#endif
+    }
+
+    // Writer only
+    void Publish(Pointer snapshot) {
+        const uint64_t generation = snapshot ? snapshot->generation : 0;
+#if defined(__cpp_lib_atomic_shared_ptr)
+        m_current.store(std::move(snapshot), std::memory_order_release);
+#else
+        std::atomic_store_explicit(&m_current, std::move(snapshot), std::memory_order_release);
+#endif
+        // After the pointer, so that a snapshot pinned after reading this is
+        // at least this new
+        m_generation.store(generation, std::memory_order_release);
+    }
+
+    // Generation of the newest published snapshot, 0 before the first
+    uint64_t Generation() const { return m_generation.load(std::memory_order_acquire); }
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<Pointer> m_current;
+#else
+    Pointer m_current; // Accessed only through the std::atomic_* overloads
+#endif
+    std::atomic<uint64_t> m_generation{ 0 };
+};
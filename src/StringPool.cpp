@@ -0,0 +1,31 @@
+#include "StringPool.h"
+
+StringPool::StringPool() {
+    Intern(std::wstring_view());
+}
+
+StringPool::StringPool(const StringPool& other)
+    : m_strings(other.m_strings)
+    , m_textLength(other.m_textLength) {
+    // The views must point into this copy's strings
+    m_ids.reserve(m_strings.size());
+    for (Id id = 0; id < m_strings.size(); ++id) {
+        m_ids.emplace(m_strings[id], id);
+    }
+}
+
+StringPool::Id StringPool::Find(std::wstring_view text) const {
+    const auto it = m_ids.find(text);
+    return it == m_ids.end() ? kMissing : it->second;
+}
+
+StringPool::Id StringPool::Intern(std::wstring_view text) {
+    const auto it = m_ids.find(text);
+    if (it != m_ids.end()) return it->second;
+
+    const Id id = static_cast<Id>(m_strings.size());
+    m_strings.emplace_back(text);
+    m_ids.emplace(m_strings.back(), id);
+    m_textLength += text.size();
+    return id;
+}
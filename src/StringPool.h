@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Interned strings, referenced by a 32-bit id. Window lists repeat the
+// same process and class names many times over; each distinct name is
+// stored once here. Id 0 is the empty string. Ids stay valid for the
+// lifetime of the pool and of every copy made from it, so a writer can
+// copy a published pool, add to the copy and publish that in turn.
+class StringPool {
+public:
+    using Id = uint32_t;
+    static constexpr Id kMissing = UINT32_MAX;
+
+    StringPool();
+    StringPool(const StringPool& other);
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Id of `text`, or kMissing if it was never interned
+    Id Find(std::wstring_view text) const;
+    Id Intern(std::wstring_view text);
+
+    const std::wstring& Get(Id id) const { return m_strings[id]; }
+    size_t Size() const { return m_strings.size(); }
+
+    // Characters held, for memory accounting
+    size_t TextLength() const { return m_textLength; }
+
+private:
+    // A deque never moves its elements, so the views stay valid
+    std::deque<std::wstring> m_strings;
+    std::unordered_map<std::wstring_view, Id> m_ids;
+    size_t m_textLength = 0;
+};
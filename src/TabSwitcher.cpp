@@ -4,10 +4,12 @@
 #include <iostream>
 #endif
 #include "Config.h"
+#include "CaseFold.h"
+#include "WindowTracker.h"
+#include "WinEventWindowSource.h"
 #include <windowsx.h>
 #include <dwmapi.h> // Include for DWM functions
 #include <algorithm>
-#include <numeric>
 #include <vector>
 
 
@@ -33,19 +35,62 @@ TabSwitcher::TabSwitcher()
     , m_font(nullptr)
     , m_backgroundBrush(nullptr)
     , m_selectedBrush(nullptr)
-    , m_stopThread(false) {
-    
-    m_windowManager = std::make_unique<WindowManager>();
+    , m_stopThread(false)
+    , m_previousForeground(nullptr)
+    , m_pendingRequest(0)
+    , m_shownRequest(0)
+    , m_keepSelected(nullptr)
+    , m_activateWhenReady(false) {
+    
+    // Late icons wake the updater like window events do
+    m_windowManager = std::make_unique<WindowManager>([this] {
+        {
+            std::lock_guard<std::mutex> lock(m_updateMutex);
+            m_windowEvents = true;
+        }
+        m_updateWake.notify_one();
+    });
+    m_iconAtlas.SetCellSize(Config::ICON_SIZE);
+    m_windowSource = std::make_unique<WinEventWindowSource>();
+
+    // The worker pins the latest snapshot itself, without a lock, so neither the UI
+    // nor the updater ever waits on a filter pass
+    m_searchWorker = std::make_unique<SearchWorker>(
+        [this]() -> std::shared_ptr<const SearchSnapshot> { return m_snapshots.Pin(); },
+        [this](uint64_t) { PostMessage(m_hwnd, WM_APP_SEARCH_DONE, 0, 0); });
+
+    SearchEngine& engine = m_searchWorker->Engine();
+    engine.SetParallelThreshold(static_cast<size_t>(std::max(Config::PARALLEL_THRESHOLD, 0)));
+    engine.SetWorkerCount(static_cast<size_t>(std::max(Config::SEARCH_THREADS, 0)));
+    engine.SetCacheCapacity(static_cast<size_t>(std::max(Config::RESULT_CACHE_SIZE, 0)));
+    engine.SetScoringPreset(Config::SCORING_PRESET);
+    engine.SetVerifyPrefilter(Config::VERIFY_PREFILTER, [](const SearchCorpus& corpus, size_t entry, double) {
+        std::wstring message = L"TabSwitcher: prefilter dropped a match: " +
+                               std::wstring(corpus.Title(entry), corpus.TitleLength(entry)) + L"\n";
+        OutputDebugStringW(message.c_str());
+    });
+
+    if (Config::FRECENCY_ENABLED) {
+        m_frecency.SetHalfLife(std::max(Config::FRECENCY_HALF_LIFE_HOURS, 1) * 60.0);
+        if (!m_frecency.Open(Config::FRECENCY_FILE)) {
+            OutputDebugStringW(L"TabSwitcher: cannot map the frecency file, history is kept in memory\n");
+        }
+        m_searchWorker->SetFrecencyStore(&m_frecency);
+    }
+    m_searchWorker->Start();
     RegisterWindowClass();
     StartWindowUpdater();
 }
 
 TabSwitcher::~TabSwitcher() {
-    StopWindowUpdater();
+    StopWindowUpdater(); // It posts index updates to the search worker
+    m_windowManager.reset(); // Its icon fetcher wakes the updater
+    m_searchWorker.reset();
     UnregisterThumbnail();
     if (m_font) DeleteObject(m_font);
     if (m_backgroundBrush) DeleteObject(m_backgroundBrush);
     if (m_selectedBrush) DeleteObject(m_selectedBrush);
+    ReleaseAtlasBitmap();
     if (m_hwnd) DestroyWindow(m_hwnd);
     UnregisterWindowClass();
 }
@@ -87,22 +132,22 @@ bool TabSwitcher::Create() {
 void TabSwitcher::Show() {
     if (m_isVisible.load()) return;
 
-    // The window list is now updated in the background.
-    // We just need to grab the latest version of it.
-    {
-        std::lock_guard<std::mutex> lock(m_windowMutex);
-        // m_windows is already up-to-date from the background thread.
-    }
-    
+    // The window list is updated in the background; the search worker
+    // filters the latest version of it and posts the result back.
+    m_previousForeground = GetForegroundWindow();
     m_searchText.clear();
-    FilterWindows();
+    m_activateWhenReady = false;
+    if (!Config::TRACE_FILE.empty()) {
+        m_trace.Clear();
+        m_trace.stripDiacritics = Config::STRIP_DIACRITICS;
+        m_traceStart = std::chrono::steady_clock::now();
+        m_tracing = true;
+    }
+    FilterWindows(); // Resets the selection, or preselects from the history
     
     // It's possible the list is empty right at the start
     // if the background thread hasn't populated it yet.
     // The UI will just show "no windows".
-    
-    m_selectedIndex = 0;
-    m_scrollOffset = 0;
 
     // Apply Mica effect if available (Windows 11+)
     BOOL micaValue = TRUE;
@@ -119,7 +164,9 @@ void TabSwitcher::Show() {
 
 void TabSwitcher::Hide() {
     if (!m_isVisible.load()) return;
+    FinishTrace(-1); // Dismissed, unless a window was activated first
     UnregisterThumbnail();
+    m_activateWhenReady = false;
     ShowWindow(m_hwnd, SW_HIDE);
     m_isVisible.store(false);
 }
@@ -200,28 +247,24 @@ LRESULT TabSwitcher::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) {
 
         case WM_APP + 2: // Refresh from background thread
             {
-                HWND previouslySelectedHwnd = nullptr;
-                if (!m_filteredWindows.empty() && m_selectedIndex < m_filteredWindows.size()) {
-                    previouslySelectedHwnd = m_filteredWindows[m_selectedIndex].hwnd;
+                // A pending pass picks up the new snapshot by itself
+                if (m_pendingRequest != m_shownRequest) {
+                    return 0;
                 }
 
-                FilterWindows(); // Rebuilds the list and resets selection to 0.
-
-                if (previouslySelectedHwnd) {
-                    auto it = std::find_if(m_filteredWindows.begin(), m_filteredWindows.end(),
-                                           [previouslySelectedHwnd](const WindowInfo& info) {
-                                               return info.hwnd == previouslySelectedHwnd;
-                                           });
-
-                    if (it != m_filteredWindows.end()) {
-                        m_selectedIndex = static_cast<int>(std::distance(m_filteredWindows.begin(), it));
-                        EnsureSelectionIsVisible();
-                    }
+                // Refilter the new snapshot; the selection follows its window
+                HWND selectedHwnd = nullptr;
+                if (m_selectedIndex >= 0 && static_cast<size_t>(m_selectedIndex) < GetResultCount()) {
+                    selectedHwnd = GetResultWindow(m_selectedIndex).hwnd;
                 }
-                InvalidateRect(m_hwnd, nullptr, TRUE); // Repaint with the restored selection
+                FilterWindows(selectedHwnd);
             }
             return 0;
 
+        case WM_APP_SEARCH_DONE:
+            OnSearchDone();
+            return 0;
+
         case WM_KILLFOCUS:
             Hide();
             return 0;
@@ -240,7 +283,7 @@ LRESULT TabSwitcher::HandleMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) {
 }
 
 void TabSwitcher::OnPaint() {
-    if (m_filteredWindows.empty() || m_selectedIndex >= m_filteredWindows.size()) {
+    if (GetResultCount() == 0 || static_cast<size_t>(m_selectedIndex) >= GetResultCount()) {
         // If there's nothing to show, just paint the default window
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(m_hwnd, &ps);
@@ -249,7 +292,7 @@ void TabSwitcher::OnPaint() {
         return;
     }
 
-    HWND targetHwnd = m_filteredWindows[m_selectedIndex].hwnd;
+    HWND targetHwnd = GetResultWindow(m_selectedIndex).hwnd;
     RegisterThumbnail(targetHwnd);
 
     if (m_hThumbnail) {
@@ -326,6 +369,7 @@ void TabSwitcher::OnKeyDown(WPARAM vkCode, bool isShiftPressed) {
         case VK_BACK:
             if (!m_searchText.empty()) {
                 m_searchText.pop_back();
+                RecordKeystroke();
                 FilterWindows();
                 InvalidateRect(m_hwnd, nullptr, TRUE);
             }
@@ -336,6 +380,7 @@ void TabSwitcher::OnKeyDown(WPARAM vkCode, bool isShiftPressed) {
 void TabSwitcher::OnChar(WPARAM ch) {
     if (ch >= 32) { // Printable characters
         m_searchText += static_cast<wchar_t>(ch);
+        RecordKeystroke();
         FilterWindows();
         InvalidateRect(m_hwnd, nullptr, TRUE);
     }
@@ -366,106 +411,132 @@ void TabSwitcher::OnCustomKeyDown(WPARAM vkCode, LPARAM lParam) {
     }
 }
 
-void TabSwitcher::FilterWindows() {
-    std::lock_guard<std::mutex> lock(m_windowMutex);
-    m_filteredWindows.clear();
-    InvalidateRect(m_hwnd, nullptr, TRUE);
-
-    if (m_searchText.empty()) {
-        m_filteredWindows = m_windows;
-    } else {
-        // For debugging: convert wstring to string for cout
+void TabSwitcher::FilterWindows(HWND keepSelected) {
+    // For debugging: convert wstring to string for cout
 #ifdef DEBUG
-        std::string search_text_str;
-        std::transform(m_searchText.begin(), m_searchText.end(), std::back_inserter(search_text_str),
-                      [](wchar_t c) { return static_cast<char>(c); });
-        std::cout << "Searching for: " << search_text_str << std::endl;
+    std::string search_text_str;
+    std::transform(m_searchText.begin(), m_searchText.end(), std::back_inserter(search_text_str),
+                  [](wchar_t c) { return static_cast<char>(c); });
+    std::cout << "Searching for: " << search_text_str << std::endl;
 #endif
 
-        // Convert search text to lowercase for case-insensitive matching
-        std::wstring search_lower = m_searchText;
-        std::transform(search_lower.begin(), search_lower.end(), search_lower.begin(), ::towlower);
+    // Fold the query exactly like the corpus was folded, into a buffer
+    // that keeps its capacity across keystrokes
+    m_foldedQuery.assign(m_searchText);
+    CaseFold::Fold(m_foldedQuery, Config::STRIP_DIACRITICS);
+
+    // The unfiltered list needs no scoring: show it right away from the
+    // snapshot on screen, the pass below brings the newest one
+    if (m_foldedQuery.empty() && !keepSelected && m_viewSnapshot) {
+        m_results.AssignAll(m_viewSnapshot->corpus.Size());
+        m_selectedIndex = 0;
+        m_scrollOffset = 0;
+    }
 
-        for (const auto& window : m_windows) {
-            // For debugging: convert wstring to string for cout
-#ifdef DEBUG
-            std::string window_title_str;
-            std::transform(window.title.begin(), window.title.end(), std::back_inserter(window_title_str),
-                          [](wchar_t c) { return static_cast<char>(c); });
+    // Keep the first pick away from the window the user is coming from
+    uint64_t avoidWindowKey = 0;
+    if (m_foldedQuery.empty() && m_viewSnapshot) {
+        const auto& windows = m_viewSnapshot->windows;
+        for (size_t i = 0; i < windows.size(); ++i) {
+            if (windows[i].hwnd == m_previousForeground) {
+                avoidWindowKey = m_viewSnapshot->frecencyKeys[i];
+                break;
+            }
+        }
+    }
 
-            std::string process_name_str;
-            std::transform(window.processName.begin(), window.processName.end(), std::back_inserter(process_name_str),
-                          [](wchar_t c) { return static_cast<char>(c); });
-#endif
+    // Rank only what the first page shows; the rest is sorted on demand
+    m_keepSelected = keepSelected;
+    m_pendingRequest = m_searchWorker->Submit(m_foldedQuery, static_cast<size_t>(std::max(GetVisibleItemCount(), 1)),
+                                              avoidWindowKey);
+}
 
-            // Convert window title and process name to lowercase for case-insensitive matching
-            std::wstring title_lower = window.title;
-            std::transform(title_lower.begin(), title_lower.end(), title_lower.begin(), ::towlower);
-            
-            std::wstring process_lower = window.processName;
-            std::transform(process_lower.begin(), process_lower.end(), process_lower.begin(), ::towlower);
-
-            // Calculate scores for window title
-            double title_fuzzy = CalculateFuzzyScore(search_lower, title_lower);
-            double title_position = CalculatePositionScore(search_lower, title_lower);
-            double title_prefix = CalculatePrefixScore(search_lower, title_lower);
-            double title_sequential = CalculateSequentialScore(search_lower, title_lower);
-
-            double title_score = (title_fuzzy * 0.3) +
-                               (title_position * 0.2) + 
-                               (title_prefix * 0.3) + 
-                               (title_sequential * 0.2);
-
-            // Calculate scores for process name
-            double process_fuzzy = CalculateFuzzyScore(search_lower, process_lower);
-            double process_position = CalculatePositionScore(search_lower, process_lower);
-            double process_prefix = CalculatePrefixScore(search_lower, process_lower);
-            double process_sequential = CalculateSequentialScore(search_lower, process_lower);
-
-            double process_score = (process_fuzzy * 0.3) +
-                                 (process_position * 0.2) + 
-                                 (process_prefix * 0.3) + 
-                                 (process_sequential * 0.2);
-
-            // Take the better score, but give a small bonus if process name matches well
-            double final_score = std::max(title_score, process_score);
-            
-            // Bonus if process name has a good match (helps with app-specific searches)
-            if (process_score > 70) {
-                final_score += 10; // Small bonus for good process name matches
+void TabSwitcher::OnSearchDone() {
+    if (!m_searchWorker->TakeResponse(m_searchResponse) || m_searchResponse.request != m_pendingRequest) {
+        return; // Superseded by a newer keystroke; its pass is on the way
+    }
+
+    m_shownRequest = m_searchResponse.request;
+    auto viewSnapshot = std::static_pointer_cast<const WindowSnapshot>(m_searchResponse.snapshot);
+    if (viewSnapshot != m_viewSnapshot) {
+        m_viewSnapshot = std::move(viewSnapshot);
+        SweepIconAtlas();
+    }
+    std::swap(m_results, m_searchResponse.results);
+    m_selectedIndex = static_cast<int>(m_searchResponse.preselect);
+    m_scrollOffset = 0;
+
+    // A background refresh keeps the selected window selected
+    if (m_keepSelected && m_viewSnapshot) {
+        const auto& windows = m_viewSnapshot->windows;
+        auto it = std::find_if(windows.begin(), windows.end(),
+                               [this](const WindowInfo& info) { return info.hwnd == m_keepSelected; });
+        if (it != windows.end()) {
+            // Corpus entries are built in window order
+            size_t rank = m_results.RankOf(static_cast<uint32_t>(std::distance(windows.begin(), it)));
+            if (rank < GetResultCount()) {
+                m_selectedIndex = static_cast<int>(rank);
             }
-            
+        }
+    }
+    m_keepSelected = nullptr;
+    EnsureSelectionIsVisible();
+
 #ifdef DEBUG
-            std::cout << "Window: '" << window_title_str << "' (Process: '" << process_name_str << "')"
-                      << " | Title Score: " << title_score << " | Process Score: " << process_score
-                      << " | Final: " << final_score << std::endl;
+    std::cout << "Matches: " << m_results.Size() << std::endl;
 #endif
 
-            // Use a threshold for quality results
-            if (final_score > 60) {
-                WindowInfo info = window;
-                info.score = final_score;
-                m_filteredWindows.push_back(info);
-            }
-        }
+    InvalidateRect(m_hwnd, nullptr, TRUE);
 
-        // Sort by score in descending order
-        std::sort(m_filteredWindows.begin(), m_filteredWindows.end(), [](const WindowInfo& a, const WindowInfo& b) {
-            return a.score > b.score;
-        });
+    if (m_activateWhenReady) {
+        m_activateWhenReady = false;
+        ActivateSelectedWindow();
     }
-    m_selectedIndex = 0;
-    m_scrollOffset = 0;
+}
+
+const WindowInfo& TabSwitcher::GetResultWindow(size_t rank) {
+    const SearchMatch& match = m_results.At(rank);
+    return m_viewSnapshot->windows[m_viewSnapshot->corpus.Source(match.entry)];
+}
+
+void TabSwitcher::RecordKeystroke() {
+    if (!m_tracing) return;
+    const auto elapsed = std::chrono::steady_clock::now() - m_traceStart;
+    m_trace.keystrokes.push_back(
+        { static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()), m_searchText });
+}
+
+void TabSwitcher::FinishTrace(int64_t chosen) {
+    if (!m_tracing) return;
+    m_tracing = false;
+
+    // Recorded against the list the user picked from, as it was searched
+    if (m_viewSnapshot) {
+        for (const WindowInfo& window : m_viewSnapshot->windows) {
+            KeystrokeTrace::Window& traced = m_trace.windows.emplace_back();
+            m_viewSnapshot->SearchTitle(window, traced.title);
+            traced.processName = m_viewSnapshot->ProcessName(window);
+        }
+    }
+    m_trace.chosen = chosen;
+
+    // The worker does the file I/O, so hiding never waits for the disk
+    m_searchWorker->Post([trace = std::move(m_trace), path = Config::TRACE_FILE](SearchEngine&) {
+        if (!trace.AppendTo(path)) {
+            OutputDebugStringW(L"TabSwitcher: cannot append to the trace file\n");
+        }
+    });
+    m_trace.Clear();
 }
 
 void TabSwitcher::SelectNext() {
-    if (m_filteredWindows.empty()) return;
+    if (GetResultCount() == 0) return;
     InvalidateRect(m_hwnd, nullptr, TRUE);
     {
         int oldSelectedIndex = m_selectedIndex;
         int oldScrollOffset = m_scrollOffset;
 
-        m_selectedIndex = (m_selectedIndex + 1) % static_cast<int>(m_filteredWindows.size());
+        m_selectedIndex = (m_selectedIndex + 1) % static_cast<int>(GetResultCount());
         EnsureSelectionIsVisible();
 
         if (m_scrollOffset != oldScrollOffset) {
@@ -480,14 +551,14 @@ void TabSwitcher::SelectNext() {
 }
 
 void TabSwitcher::SelectPrevious() {
-    if (m_filteredWindows.empty()) return;
+    if (GetResultCount() == 0) return;
     InvalidateRect(m_hwnd, nullptr, TRUE);
     {
         int oldSelectedIndex = m_selectedIndex;
         int oldScrollOffset = m_scrollOffset;
 
-        m_selectedIndex = (m_selectedIndex - 1 + static_cast<int>(m_filteredWindows.size())) 
-                         % static_cast<int>(m_filteredWindows.size());
+        m_selectedIndex = (m_selectedIndex - 1 + static_cast<int>(GetResultCount())) 
+                         % static_cast<int>(GetResultCount());
         EnsureSelectionIsVisible();
 
         if (m_scrollOffset != oldScrollOffset) {
@@ -502,8 +573,25 @@ void TabSwitcher::SelectPrevious() {
 }
 
 void TabSwitcher::ActivateSelectedWindow() {
-    if (m_selectedIndex >= 0 && m_selectedIndex < static_cast<int>(m_filteredWindows.size())) {
-        const WindowInfo& window = m_filteredWindows[m_selectedIndex];
+    if (m_pendingRequest != m_shownRequest) {
+        m_activateWhenReady = true; // Pick from what the user typed, not the stale list
+        return;
+    }
+
+    if (m_selectedIndex >= 0 && m_selectedIndex < static_cast<int>(GetResultCount())) {
+        const WindowInfo& window = GetResultWindow(m_selectedIndex);
+        const uint32_t source = m_viewSnapshot->corpus.Source(m_results.At(m_selectedIndex).entry);
+        FinishTrace(source);
+
+        if (Config::FRECENCY_ENABLED) {
+            const uint64_t windowKey = m_viewSnapshot->frecencyKeys[source];
+            const uint32_t now = FrecencyStore::Now();
+            std::wstring query = CaseFold::Folded(m_searchText, Config::STRIP_DIACRITICS);
+            m_searchWorker->Post([this, windowKey, query, now](SearchEngine& engine) {
+                m_frecency.RecordActivation(windowKey, query, now);
+                engine.ClearCache(); // Cached rankings include the old boosts
+            });
+        }
 
         Hide();
         m_windowManager->ActivateWindow(window.hwnd);
@@ -528,11 +616,11 @@ void TabSwitcher::DrawWindow(HDC hdc) {
 
     for (int i = 0; i < maxVisibleItems; ++i) {
         int itemIndex = m_scrollOffset + i;
-        if (itemIndex >= static_cast<int>(m_filteredWindows.size())) {
+        if (itemIndex >= static_cast<int>(GetResultCount())) {
             break;
         }
         
-        DrawWindowItem(hdc, m_filteredWindows[itemIndex], itemIndex, y);
+        DrawWindowItem(hdc, GetResultWindow(itemIndex), itemIndex, y);
         y += Config::ITEM_HEIGHT;
     }
     
@@ -611,12 +699,12 @@ void TabSwitcher::DrawWindowItem(HDC hdc, const WindowInfo& window, int index, i
     int x = itemRect.left + Config::PADDING + 15; // Indent text a bit more
     
     if (window.icon) {
-        DrawIconEx(hdc, x, y + (Config::ITEM_HEIGHT - Config::ICON_SIZE) / 2, window.icon, 
-                   Config::ICON_SIZE, Config::ICON_SIZE, 0, nullptr, DI_NORMAL);
+        DrawIcon(hdc, window.icon.get(), x, y + (Config::ITEM_HEIGHT - Config::ICON_SIZE) / 2);
     }
     x += Config::ICON_SIZE + Config::PADDING;
     
-    std::wstring displayText = window.title;
+    std::wstring displayText;
+    m_viewSnapshot->SearchTitle(window, displayText);
     
     COLORREF textColor = Config::TEXT_COLOR; // Text color is now consistent
     DrawTextString(hdc, displayText, x, y + (Config::ITEM_HEIGHT - 20) / 2,
@@ -624,7 +712,80 @@ void TabSwitcher::DrawWindowItem(HDC hdc, const WindowInfo& window, int index, i
 }
 
 void TabSwitcher::DrawIcon(HDC hdc, HICON icon, int x, int y) {
-    DrawIconEx(hdc, x, y, icon, Config::ICON_SIZE, Config::ICON_SIZE, 0, nullptr, DI_NORMAL);
+    // Icons are keyed by handle; windows of one executable share theirs
+    const IconAtlas::Key key = reinterpret_cast<uintptr_t>(icon);
+    const IconAtlas::Cell* cell = m_iconAtlas.Find(key);
+    IconAtlas::Cell added;
+    if (!cell && Utils::RenderIcon(icon, m_iconAtlas.CellSize(), m_iconPixels)) {
+        added = m_iconAtlas.Insert(key, m_iconPixels.data());
+        cell = &added;
+    }
+    if (!cell || !SyncAtlasBitmap()) {
+        DrawIconEx(hdc, x, y, icon, Config::ICON_SIZE, Config::ICON_SIZE, 0, nullptr, DI_NORMAL);
+        return;
+    }
+
+    const int size = m_iconAtlas.CellSize();
+    const BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+    AlphaBlend(hdc, x, y, size, size, m_atlasDC, cell->x, cell->y, size, size, blend);
+}
+
+bool TabSwitcher::SyncAtlasBitmap() {
+    if (m_atlasVersion == m_iconAtlas.Version()) {
+        return m_atlasDC != nullptr;
+    }
+
+    // The atlas only grows by whole rows; the bitmap follows it
+    if (!m_atlasBitmap || m_atlasHeight != m_iconAtlas.Height()) {
+        ReleaseAtlasBitmap();
+        BITMAPINFO bitmapInfo = {};
+        bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bitmapInfo.bmiHeader.biWidth = m_iconAtlas.Width();
+        bitmapInfo.bmiHeader.biHeight = -m_iconAtlas.Height(); // Top-down, as the atlas
+        bitmapInfo.bmiHeader.biPlanes = 1;
+        bitmapInfo.bmiHeader.biBitCount = 32;
+        bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+        m_atlasDC = CreateCompatibleDC(nullptr);
+        m_atlasBitmap = CreateDIBSection(m_atlasDC, &bitmapInfo, DIB_RGB_COLORS, &m_atlasBits, nullptr, 0);
+        if (!m_atlasDC || !m_atlasBitmap) {
+            ReleaseAtlasBitmap();
+            return false;
+        }
+        m_atlasOldBitmap = SelectObject(m_atlasDC, m_atlasBitmap);
+        m_atlasHeight = m_iconAtlas.Height();
+    }
+
+    GdiFlush();
+    std::copy_n(m_iconAtlas.Pixels(), static_cast<size_t>(m_iconAtlas.Width()) * m_iconAtlas.Height(),
+                static_cast<uint32_t*>(m_atlasBits));
+    m_atlasVersion = m_iconAtlas.Version();
+    return true;
+}
+
+void TabSwitcher::ReleaseAtlasBitmap() {
+    if (m_atlasDC && m_atlasOldBitmap) SelectObject(m_atlasDC, m_atlasOldBitmap);
+    if (m_atlasBitmap) DeleteObject(m_atlasBitmap);
+    if (m_atlasDC) DeleteDC(m_atlasDC);
+    m_atlasDC = nullptr;
+    m_atlasBitmap = nullptr;
+    m_atlasOldBitmap = nullptr;
+    m_atlasBits = nullptr;
+    m_atlasHeight = 0;
+    m_atlasVersion = UINT64_MAX;
+}
+
+void TabSwitcher::SweepIconAtlas() {
+    // A borrowed icon handle can be reused once its window is gone, so
+    // cells are kept only for icons of the windows now listed
+    std::vector<IconAtlas::Key> live;
+    if (m_viewSnapshot) {
+        live.reserve(m_viewSnapshot->windows.size());
+        for (const WindowInfo& window : m_viewSnapshot->windows) {
+            if (window.icon) live.push_back(reinterpret_cast<uintptr_t>(window.icon.get()));
+        }
+    }
+    m_iconAtlas.Sweep(live);
 }
 
 void TabSwitcher::DrawTextString(HDC hdc, const std::wstring& text, int x, int y, int width, COLORREF color) {
@@ -633,12 +794,16 @@ void TabSwitcher::DrawTextString(HDC hdc, const std::wstring& text, int x, int y
     DrawTextW(hdc, text.c_str(), -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE | DT_END_ELLIPSIS | DT_NOCLIP);
 }
 
-void TabSwitcher::EnsureSelectionIsVisible() {
+int TabSwitcher::GetVisibleItemCount() {
     RECT clientRect;
     GetClientRect(m_hwnd, &clientRect);
 
     int listTopY = Config::PADDING + Config::ITEM_HEIGHT;
-    int maxVisibleItems = (clientRect.bottom - listTopY) / Config::ITEM_HEIGHT;
+    return (clientRect.bottom - listTopY) / Config::ITEM_HEIGHT;
+}
+
+void TabSwitcher::EnsureSelectionIsVisible() {
+    int maxVisibleItems = GetVisibleItemCount();
 
     if (m_selectedIndex < m_scrollOffset) {
         m_scrollOffset = m_selectedIndex;
@@ -682,175 +847,127 @@ void TabSwitcher::UnregisterThumbnail() {
     }
 }
 
-// Improved fuzzy matching scoring methods
-
-double TabSwitcher::CalculateFuzzyScore(const std::wstring& search, const std::wstring& target) {
-    // Simple Levenshtein distance-based ratio expressed as percentage
-    const size_t m = search.size();
-    const size_t n = target.size();
-    if (m == 0) return n == 0 ? 100.0 : 0.0;
-    if (n == 0) return 0.0;
+void TabSwitcher::StartWindowUpdater() {
+    m_updateThread = std::thread([this] {
+        UpdateWindowsInBackground();
+    });
+}
 
-    std::vector<size_t> prev(n + 1), curr(n + 1);
-    std::iota(prev.begin(), prev.end(), 0);
-    for (size_t i = 0; i < m; ++i) {
-        curr[0] = i + 1;
-        for (size_t j = 0; j < n; ++j) {
-            size_t cost = search[i] == target[j] ? 0 : 1;
-            curr[j + 1] = std::min({ prev[j + 1] + 1, curr[j] + 1, prev[j] + cost });
-        }
-        std::swap(prev, curr);
+void TabSwitcher::StopWindowUpdater() {
+    {
+        std::lock_guard<std::mutex> lock(m_updateMutex);
+        m_stopThread = true;
+    }
+    m_updateWake.notify_all();
+    if (m_updateThread.joinable()) {
+        m_updateThread.join();
     }
-
-    double dist = static_cast<double>(prev[n]);
-    double maxLen = static_cast<double>(std::max(m, n));
-    return (1.0 - dist / maxLen) * 100.0;
 }
 
-double TabSwitcher::CalculatePositionScore(const std::wstring& search, const std::wstring& target) {
-    if (search.empty() || target.empty()) return 0.0;
-    
-    double score = 0.0;
-    size_t search_len = search.length();
-    size_t target_len = target.length();
-    
-    // Find each character of search in target and calculate position bonus
-    size_t last_found_pos = 0;
-    double position_penalty = 0.0;
-    
-    for (size_t i = 0; i < search_len; ++i) {
-        size_t found_pos = target.find(search[i], last_found_pos);
-        if (found_pos != std::wstring::npos) {
-            // Earlier positions get higher scores
-            double position_score = 1.0 - (static_cast<double>(found_pos) / target_len);
-            score += position_score;
-            last_found_pos = found_pos + 1;
-        } else {
-            // Character not found, apply penalty
-            position_penalty += 0.2;
+void TabSwitcher::UpdateWindowsInBackground() {
+    using Clock = std::chrono::steady_clock;
+
+    // Window events keep the list current; a full enumeration every so
+    // often catches whatever they missed. Without events, enumerating is
+    // all there is, so it happens as often as the list used to be polled.
+    const bool watching = m_windowSource->Start([this] {
+        {
+            std::lock_guard<std::mutex> lock(m_updateMutex);
+            m_windowEvents = true;
         }
+        m_updateWake.notify_one();
+    });
+    if (!watching) {
+        OutputDebugStringW(L"TabSwitcher: cannot hook window events, polling the window list\n");
     }
-    
-    // Normalize score and apply penalty
-    score = (score / search_len) * 100.0;
-    score = std::max(0.0, score - (position_penalty * 100.0));
-    
-    return score;
-}
-
-double TabSwitcher::CalculatePrefixScore(const std::wstring& search, const std::wstring& target) {
-    if (search.empty() || target.empty()) return 0.0;
-    
-    double score = 0.0;
-    
-    // Check for exact prefix match
-    if (target.find(search) == 0) {
-        score = 100.0; // Perfect prefix match
-    } else {
-        // Check for word-start prefix matches
-        size_t pos = 0;
-        while ((pos = target.find(L' ', pos)) != std::wstring::npos) {
-            pos++; // Move past the space
-            if (pos < target.length()) {
-                std::wstring word_start = target.substr(pos);
-                if (word_start.find(search) == 0) {
-                    score = 80.0; // Word start match
-                    break;
-                }
-            }
+    const auto reconcileInterval = watching ? std::chrono::seconds(std::max(Config::RECONCILE_SECONDS, 1))
+                                            : std::chrono::seconds(2);
+    // Events come in bursts (a window opening raises several); wait for the
+    // rest of one before reading
+    const auto settleDelay = std::chrono::milliseconds(25);
+
+    WindowTracker tracker(*m_windowSource);
+    std::vector<WindowEvent> events;
+    WindowDelta delta;
+    uint64_t generation = 0;
+    Clock::time_point nextReconcile = Clock::now();
+    bool woken = false;
+    while (!m_stopThread) {
+        if (woken) {
+            std::this_thread::sleep_for(settleDelay);
         }
-        
-        // Check for character-level prefix matching
-        if (score == 0.0) {
-            size_t matching_chars = 0;
-            size_t min_len = std::min(search.length(), target.length());
-            
-            for (size_t i = 0; i < min_len; ++i) {
-                if (search[i] == target[i]) {
-                    matching_chars++;
-                } else {
-                    break;
-                }
-            }
-            
-            if (matching_chars > 0) {
-                score = (static_cast<double>(matching_chars) / search.length()) * 60.0;
-            }
+
+        bool changed = false;
+        bool reconciled = false;
+        events.clear();
+        delta.Clear();
+        m_windowSource->TakeEvents(events);
+        if (Clock::now() >= nextReconcile) {
+            // The enumeration supersedes any events taken with it
+            changed = tracker.Reconcile() || generation == 0;
+            reconciled = true;
+            nextReconcile = Clock::now() + reconcileInterval;
+        } else {
+            changed = tracker.Apply(events);
         }
-    }
-    
-    return score;
-}
 
-double TabSwitcher::CalculateSequentialScore(const std::wstring& search, const std::wstring& target) {
-    if (search.empty() || target.empty()) return 0.0;
-    
-    double score = 0.0;
-    size_t search_len = search.length();
-    size_t target_len = target.length();
-    
-    // Find longest consecutive character sequences
-    size_t max_consecutive = 0;
-    size_t current_consecutive = 0;
-    size_t total_matches = 0;
-    
-    size_t search_idx = 0;
-    size_t target_idx = 0;
-    
-    while (search_idx < search_len && target_idx < target_len) {
-        if (search[search_idx] == target[target_idx]) {
-            current_consecutive++;
-            total_matches++;
-            search_idx++;
-            target_idx++;
-            max_consecutive = std::max(max_consecutive, current_consecutive);
+        // Unchanged windows keep their entries; nothing is published if none changed
+        changed = changed && m_windowManager->Update(tracker.Windows(), delta);
+        if (reconciled) {
+            m_windowManager->RequestIcons();
         } else {
-            current_consecutive = 0;
-            target_idx++;
+            m_windowManager->RequestIcons(events);
         }
+        changed |= m_windowManager->ApplyFetchedIcons();
+        if (changed || generation == 0) {
+#ifdef DEBUG
+            std::wcout << L"Window list: " << delta.added.size() << L" added, " << delta.removed.size()
+                       << L" removed, " << delta.changed.size() << L" changed, "
+                       << m_windowManager->TimedOutWindows() << L" timed out so far" << std::endl;
+#endif
+            PublishSnapshot(++generation);
+        }
+
+        std::unique_lock<std::mutex> lock(m_updateMutex);
+        woken = m_updateWake.wait_until(lock, nextReconcile, [this] { return m_windowEvents || m_stopThread; });
+        m_windowEvents = false;
     }
-    
-    if (total_matches > 0) {
-        // Base score from match ratio
-        double match_ratio = static_cast<double>(total_matches) / search_len;
-        
-        // Bonus for consecutive characters
-        double consecutive_bonus = static_cast<double>(max_consecutive) / search_len;
-        
-        // Combined score with extra weight for consecutive matches
-        score = (match_ratio * 60.0) + (consecutive_bonus * 40.0);
-    }
-    
-    return score;
-}
 
-void TabSwitcher::StartWindowUpdater() {
-    m_updateThread = std::thread([this] {
-        UpdateWindowsInBackground();
-    });
+    m_windowSource->Stop();
 }
 
-void TabSwitcher::StopWindowUpdater() {
-    m_stopThread = true;
-    if (m_updateThread.joinable()) {
-        m_updateThread.join();
+void TabSwitcher::PublishSnapshot(uint64_t generation) {
+    // Fold the search text once per snapshot, off the UI thread
+    auto snapshot = std::make_shared<WindowSnapshot>();
+    snapshot->windows = m_windowManager->Windows();
+    snapshot->names = m_windowManager->PublishNames();
+    snapshot->timedOutWindows = m_windowManager->TimedOutWindows();
+    snapshot->generation = generation;
+
+    size_t textLength = 0;
+    for (const auto& window : snapshot->windows) {
+        textLength += window.title.size() + 2 * snapshot->ProcessName(window).size() + 3;
+    }
+    snapshot->frecencyKeys.reserve(snapshot->windows.size());
+    for (const auto& window : snapshot->windows) {
+        snapshot->frecencyKeys.push_back(FrecencyStore::WindowKey(snapshot->ProcessName(window), window.title));
     }
-}
 
-void TabSwitcher::UpdateWindowsInBackground() {
-    while (!m_stopThread) {
-        auto newWindows = m_windowManager->GetAllWindows();
-        {
-            std::lock_guard<std::mutex> lock(m_windowMutex);
-            m_windows = std::move(newWindows);
-        }
+    // The process name stays searchable as part of the title, as listed
+    std::wstring searchTitle;
+    snapshot->corpus.SetStripDiacritics(Config::STRIP_DIACRITICS);
+    snapshot->corpus.Reserve(snapshot->windows.size(), textLength);
+    for (size_t i = 0; i < snapshot->windows.size(); ++i) {
+        const WindowInfo& window = snapshot->windows[i];
+        snapshot->SearchTitle(window, searchTitle);
+        snapshot->corpus.Add(searchTitle, snapshot->ProcessName(window), static_cast<uint32_t>(i));
+    }
 
-        // If the window is visible, refresh the filtered list
-        if (m_isVisible.load()) {
-            PostMessage(m_hwnd, WM_APP + 2, 0, 0); // Custom message to refresh
-        }
+    // The previous snapshot lives on while the UI or the worker still holds it
+    m_snapshots.Publish(std::move(snapshot));
 
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+    // If the window is visible, refresh the filtered list
+    if (m_isVisible.load()) {
+        PostMessage(m_hwnd, WM_APP + 2, 0, 0); // Custom message to refresh
     }
 }
- 
\ No newline at end of file
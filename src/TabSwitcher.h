@@ -3,17 +3,27 @@
 #include "Utils.h"
 #include "WindowManager.h"
 #include "Config.h"
+#include "SearchWorker.h"
+#include "FrecencyStore.h"
+#include "WindowSnapshot.h"
+#include "KeystrokeTrace.h"
+#include "WindowSource.h"
+#include "IconAtlas.h"
+#include "SnapshotPublisher.h"
 #include <vector>
 #include <string>
 #include <memory>
 #include <chrono>
+#include <cstdint>
 #include <algorithm>
 #include <dwmapi.h>
 
 constexpr UINT WM_APP_KEYDOWN = WM_APP + 1;
+constexpr UINT WM_APP_SEARCH_DONE = WM_APP + 3; // A filter pass finished on the search worker
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <atomic>
 
 class TabSwitcher {
@@ -33,19 +43,22 @@ private:
     void CenterOnScreen();
     void RegisterThumbnail(HWND targetHwnd);
     void UnregisterThumbnail();
-    void FilterWindows();
+    void FilterWindows(HWND keepSelected = nullptr);
+    void OnSearchDone();
+    void RecordKeystroke();
+    void FinishTrace(int64_t chosen);
     void EnsureSelectionIsVisible();
+    int GetVisibleItemCount();
+
+    // Filtered results, in rank order
+    size_t GetResultCount() const { return m_results.Size(); }
+    const WindowInfo& GetResultWindow(size_t rank);
     
     // Background thread for updating window list
     void StartWindowUpdater();
     void StopWindowUpdater();
     void UpdateWindowsInBackground();
-
-    // Fuzzy matching scoring methods
-    double CalculateFuzzyScore(const std::wstring& search, const std::wstring& target);
-    double CalculatePositionScore(const std::wstring& search, const std::wstring& target);
-    double CalculatePrefixScore(const std::wstring& search, const std::wstring& target);
-    double CalculateSequentialScore(const std::wstring& search, const std::wstring& target);
+    void PublishSnapshot(uint64_t generation);
 
     // Window management
     HWND m_hwnd;
@@ -55,24 +68,57 @@ private:
     
     // Window data
     std::unique_ptr<WindowManager> m_windowManager;
-    std::vector<WindowInfo> m_windows;
-    std::vector<WindowInfo> m_filteredWindows;
+    SnapshotPublisher<WindowSnapshot> m_snapshots;        // Latest from the updater, pinned without locking
+    std::shared_ptr<const WindowSnapshot> m_viewSnapshot; // The one m_results indexes into (UI thread only)
+    SearchResults m_results;
+
+    // Activation history, blended into the ranking; used on the search worker only
+    FrecencyStore m_frecency;
+    HWND m_previousForeground;   // Active window before the switcher opened
+
+    // Filtering runs on the search worker; the UI shows the last finished pass
+    std::unique_ptr<SearchWorker> m_searchWorker;
+    SearchWorker::Response m_searchResponse;
+    uint64_t m_pendingRequest;   // Newest submitted pass
+    uint64_t m_shownRequest;     // Pass currently on screen
+    HWND m_keepSelected;         // Window to keep selected when the pending pass lands
+    bool m_activateWhenReady;    // Enter was pressed while a pass was pending
+
+    // Session being recorded for Config::TRACE_FILE
+    KeystrokeTrace m_trace;
+    std::chrono::steady_clock::time_point m_traceStart;
+    bool m_tracing = false;
     
     // Threading for window updates
     std::thread m_updateThread;
-    std::mutex m_windowMutex;
     std::atomic<bool> m_stopThread;
+    std::unique_ptr<WindowSource> m_windowSource; // Used by the updater thread only
+    std::mutex m_updateMutex;
+    std::condition_variable m_updateWake; // Window events or stop
+    bool m_windowEvents = false;          // Guarded by m_updateMutex
     
     // UI state
     int m_selectedIndex;
     int m_scrollOffset;
     std::wstring m_searchText;
+    std::wstring m_foldedQuery; // Folded m_searchText, reused per keystroke
     bool m_isCaretVisible;
     
     // GDI objects
     HFONT m_font;
     HBRUSH m_backgroundBrush;
     HBRUSH m_selectedBrush;
+
+    // Row icons, each rendered once into the atlas and blitted from its copy
+    // in m_atlasBitmap (UI thread only)
+    IconAtlas m_iconAtlas;
+    std::vector<uint32_t> m_iconPixels;
+    HDC m_atlasDC = nullptr;
+    HBITMAP m_atlasBitmap = nullptr;
+    HGDIOBJ m_atlasOldBitmap = nullptr;
+    void* m_atlasBits = nullptr;
+    int m_atlasHeight = 0;
+    uint64_t m_atlasVersion = UINT64_MAX;
     
     // Static window procedure
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
@@ -93,6 +139,9 @@ private:
     void DrawSearchBox(HDC hdc);
     void DrawWindowItem(HDC hdc, const WindowInfo& window, int index, int y);
     void DrawIcon(HDC hdc, HICON icon, int x, int y);
+    bool SyncAtlasBitmap();
+    void ReleaseAtlasBitmap();
+    void SweepIconAtlas();
     void DrawTextString(HDC hdc, const std::wstring& text, int x, int y, int width, COLORREF color);
     RECT GetItemRect(int index);
 
@@ -1,45 +1,43 @@
 #include "Utils.h"
 #include "Config.h"
+#include "CaseFold.h"
+#include "IconAtlas.h"
 #include <algorithm>
 #include <cctype>
 #include <cwctype>
-#include <tlhelp32.h>
 #include <shellapi.h>
 #include <map>
+#include <string_view>
 #include <vector>
 
 namespace Utils {
 
-std::wstring GetProcessName(DWORD processId) {
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE) {
-        return L"";
-    }
-
-    PROCESSENTRY32W pe32;
-    pe32.dwSize = sizeof(PROCESSENTRY32W);
-
-    if (Process32FirstW(hSnapshot, &pe32)) {
-        do {
-            if (pe32.th32ProcessID == processId) {
-                CloseHandle(hSnapshot);
-                return std::wstring(pe32.szExeFile);
-            }
-        } while (Process32NextW(hSnapshot, &pe32));
+bool QueryWindowIcon(HWND hwnd, UINT timeoutMs, HICON& icon) {
+    icon = nullptr;
+    const ULONGLONG deadline = GetTickCount64() + timeoutMs;
+    for (WPARAM type : { ICON_SMALL, ICON_BIG }) {
+        const ULONGLONG now = GetTickCount64();
+        DWORD_PTR result = 0;
+        if (now >= deadline) {
+            return !IsWindow(hwnd); // A window that is gone has nothing more to say
+        }
+        if (!SendMessageTimeoutW(hwnd, WM_GETICON, type, 0, SMTO_ABORTIFHUNG | SMTO_ERRORONEXIT,
+                                 static_cast<UINT>(deadline - now), &result)) {
+            // Only a timeout or a hung window is worth asking again; any other
+            // failure (ERROR_ACCESS_DENIED from an elevated window) is final
+            return GetLastError() != ERROR_TIMEOUT || !IsWindow(hwnd);
+        }
+        icon = reinterpret_cast<HICON>(result);
+        if (icon) break;
     }
-
-    CloseHandle(hSnapshot);
-    return L"";
+    return true;
 }
 
-HICON GetWindowIcon(HWND hwnd, bool& destroyIcon) {
-    destroyIcon = false;
-
-    // Try to get the icon from the window
-    HICON icon = reinterpret_cast<HICON>(SendMessageW(hwnd, WM_GETICON, ICON_SMALL, 0));
-    if (!icon) {
-        icon = reinterpret_cast<HICON>(SendMessageW(hwnd, WM_GETICON, ICON_BIG, 0));
-    }
+IconHandle GetWindowIcon(HWND hwnd, DWORD processId, ExecutableIcons& executableIcons, UINT timeoutMs,
+                         bool& timedOut) {
+    // Try to get the icon from the window; this is the one call that waits on its process
+    HICON icon = nullptr;
+    timedOut = !QueryWindowIcon(hwnd, timeoutMs, icon);
     if (!icon) {
         icon = reinterpret_cast<HICON>(GetClassLongPtrW(hwnd, GCLP_HICONSM));
     }
@@ -49,25 +47,74 @@ HICON GetWindowIcon(HWND hwnd, bool& destroyIcon) {
 
     // If still no icon, try to get it from the executable
     if (!icon) {
-        DWORD processId;
-        GetWindowThreadProcessId(hwnd, &processId);
-
         HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
         if (hProcess) {
             wchar_t exePath[MAX_PATH];
             DWORD size = MAX_PATH;
             if (QueryFullProcessImageNameW(hProcess, 0, exePath, &size)) {
+                std::weak_ptr<std::remove_pointer_t<HICON>>& cached = executableIcons[exePath];
+                IconHandle shared = cached.lock();
                 SHFILEINFOW fileInfo;
-                if (SHGetFileInfoW(exePath, 0, &fileInfo, sizeof(fileInfo), SHGFI_ICON | SHGFI_SMALLICON)) {
-                    icon = fileInfo.hIcon;
-                    destroyIcon = true;
+                if (!shared && SHGetFileInfoW(exePath, 0, &fileInfo, sizeof(fileInfo), SHGFI_ICON | SHGFI_SMALLICON)) {
+                    shared = IconHandle(fileInfo.hIcon, DestroyIcon);
+                    cached = shared;
+                }
+                if (shared) {
+                    CloseHandle(hProcess);
+                    return shared;
                 }
             }
             CloseHandle(hProcess);
         }
     }
 
-    return icon;
+    return BorrowIcon(icon);
+}
+
+IconHandle BorrowIcon(HICON icon) {
+    return icon ? IconHandle(icon, [](HICON) {}) : IconHandle();
+}
+
+bool RenderIcon(HICON icon, int size, std::vector<uint32_t>& pixels) {
+    BITMAPINFO bitmapInfo = {};
+    bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bitmapInfo.bmiHeader.biWidth = size;
+    bitmapInfo.bmiHeader.biHeight = -size; // Top-down
+    bitmapInfo.bmiHeader.biPlanes = 1;
+    bitmapInfo.bmiHeader.biBitCount = 32;
+    bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HDC hdc = CreateCompatibleDC(nullptr);
+    HBITMAP bitmap = CreateDIBSection(hdc, &bitmapInfo, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!hdc || !bitmap) {
+        if (bitmap) DeleteObject(bitmap);
+        if (hdc) DeleteDC(hdc);
+        return false;
+    }
+    HGDIOBJ oldBitmap = SelectObject(hdc, bitmap);
+
+    // Drawn over black and over white, which recovers the alpha of
+    // alpha-channel and masked icons alike
+    const size_t count = static_cast<size_t>(size) * size;
+    std::vector<uint32_t> onBlack(count);
+    bool drawn = true;
+    for (uint32_t background : { 0x00000000u, 0x00FFFFFFu }) {
+        std::fill_n(static_cast<uint32_t*>(bits), count, background);
+        GdiFlush();
+        drawn &= DrawIconEx(hdc, 0, 0, icon, size, size, 0, nullptr, DI_NORMAL) != FALSE;
+        GdiFlush();
+        if (background == 0) std::copy_n(static_cast<const uint32_t*>(bits), count, onBlack.data());
+    }
+    if (drawn) {
+        pixels.resize(count);
+        IconAtlas::FromBlackAndWhite(onBlack.data(), static_cast<const uint32_t*>(bits), pixels.data(), count);
+    }
+
+    SelectObject(hdc, oldBitmap);
+    DeleteObject(bitmap);
+    DeleteDC(hdc);
+    return drawn;
 }
 
 void CenterWindow(HWND hwnd, int width, int height) {
@@ -89,69 +136,73 @@ void CenterWindow(HWND hwnd, int width, int height) {
     SetWindowPos(hwnd, nullptr, x, y, width, height, SWP_NOZORDER);
 }
 
-bool IsValidWindow(HWND hwnd) {
+bool ReadWindow(HWND hwnd, WindowCandidate& candidate) {
+    candidate.hwnd = hwnd;
     if (!hwnd || !IsWindow(hwnd) || !IsWindowVisible(hwnd)) {
         return false;
     }
 
+    candidate.exStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
+    candidate.parent = GetParent(hwnd);
+    candidate.isMinimized = IsIconic(hwnd) != FALSE;
+    GetWindowThreadProcessId(hwnd, &candidate.processId);
+    // Unlike GetWindowTextW, never sends WM_GETTEXT, so a hung window cannot stall the read
+    candidate.titleLength = std::max(InternalGetWindowText(hwnd, candidate.title, 512), 0);
+    candidate.classNameLength = std::max(GetClassNameW(hwnd, candidate.className, 256), 0);
+    return true;
+}
+
+bool IsValidWindow(const WindowCandidate& candidate, const ProcessTable& processes) {
     // Basic properties check
-    LONG exStyle = GetWindowLongW(hwnd, GWL_EXSTYLE);
-    if (exStyle & WS_EX_TOOLWINDOW) {
+    if (candidate.exStyle & WS_EX_TOOLWINDOW) {
         return false;
     }
-    if (GetParent(hwnd) != nullptr) {
+    if (candidate.parent != nullptr) {
         return false;
     }
 
     // Check for a valid title
-    wchar_t windowTitle[512];
-    if (GetWindowTextW(hwnd, windowTitle, 512) == 0) {
+    if (candidate.titleLength == 0) {
         return false;
     }
-    std::wstring titleStr(windowTitle);
-
-    // Get process info
-    DWORD processId;
-    GetWindowThreadProcessId(hwnd, &processId);
-    std::wstring processName = GetProcessName(processId);
 
     // --- Custom Filtering Logic ---
-    if (!processName.empty()) {
-        std::transform(processName.begin(), processName.end(), processName.begin(), ::towlower);
-        for (const auto& excludedProc : Config::EXCLUDED_PROCESSES) {
-            std::wstring lowerExcludedProc = excludedProc;
-            std::transform(lowerExcludedProc.begin(), lowerExcludedProc.end(), lowerExcludedProc.begin(), ::towlower);
-            if (processName == lowerExcludedProc) {
-                return false;
-            }
-        }
+    const ProcessTable::Process* process = processes.Find(candidate.processId);
+    if (process && process->excluded) {
+        return false;
     }
 
-    if (!titleStr.empty()) {
-        std::wstring lowerTitle = titleStr;
-        std::transform(lowerTitle.begin(), lowerTitle.end(), lowerTitle.begin(), ::towlower);
+    if (!Config::EXCLUDED_TITLES.empty()) {
+        std::wstring lowerTitle(candidate.title, candidate.titleLength);
+        CaseFold::Fold(lowerTitle, Config::STRIP_DIACRITICS);
         for (const auto& excludedTitle : Config::EXCLUDED_TITLES) {
-            std::wstring lowerExcludedTitle = excludedTitle;
-            std::transform(lowerExcludedTitle.begin(), lowerExcludedTitle.end(), lowerExcludedTitle.begin(), ::towlower);
-            if (lowerTitle.find(lowerExcludedTitle) != std::wstring::npos) {
+            if (lowerTitle.find(excludedTitle) != std::wstring::npos) {
                 return false;
             }
         }
     }
 
     // --- System-level Filtering ---
-    wchar_t className[256];
-    GetClassNameW(hwnd, className, 256);
-    std::wstring classNameStr(className);
-    if (classNameStr == L"Shell_TrayWnd" ||
-        classNameStr == L"Progman" ||
-        classNameStr == L"Windows.UI.Core.CoreWindow") { // UWP app host
+    const std::wstring_view className(candidate.className, candidate.classNameLength);
+    if (className == L"Shell_TrayWnd" ||
+        className == L"Progman" ||
+        className == L"Windows.UI.Core.CoreWindow") { // UWP app host
         return false;
     }
 
     return true;
 }
 
+bool IsValidWindow(HWND hwnd) {
+    WindowCandidate candidate;
+    if (!ReadWindow(hwnd, candidate)) {
+        return false;
+    }
+    ProcessTable processes;
+    processes.Refresh();
+    return IsValidWindow(candidate, processes);
+}
+
 UINT StringToVK(const std::wstring& key) {
     static const std::map<std::wstring, UINT> keyMap = {
         {L"LBUTTON", VK_LBUTTON},
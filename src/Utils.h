@@ -4,111 +4,73 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
 #include <regex>
 
 #include "Config.h" // Include the centralized config file
+#include "StringPool.h"
+#include "ProcessTable.h"
 
-// Window information structure
-struct WindowInfo {
-    HWND hwnd;
-    std::wstring title;
-    std::wstring className;
-    std::wstring processName;
-    DWORD processId;
-    bool isVisible;
-    bool isMinimized;
-    HICON icon;
-    bool destroyIcon;
-    double score = 0.0;
-
-    WindowInfo()
-        : hwnd(nullptr), processId(0), isVisible(false),
-          isMinimized(false), icon(nullptr), destroyIcon(false),
-          score(0.0) {}
-
-    ~WindowInfo() {
-        if (destroyIcon && icon) {
-            DestroyIcon(icon);
-        }
-    }
-
-    WindowInfo(const WindowInfo& other)
-        : hwnd(other.hwnd), title(other.title), className(other.className),
-          processName(other.processName), processId(other.processId),
-          isVisible(other.isVisible), isMinimized(other.isMinimized),
-          icon(nullptr), destroyIcon(other.destroyIcon),
-          score(other.score) {
-        if (other.icon) {
-            icon = destroyIcon ? CopyIcon(other.icon) : other.icon;
-        }
-    }
-
-    WindowInfo& operator=(const WindowInfo& other) {
-        if (this != &other) {
-            if (destroyIcon && icon) {
-                DestroyIcon(icon);
-            }
+// An icon shared by every list entry, in every snapshot, that shows it.
+// Icons loaded from the executable are destroyed with the last reference;
+// icons borrowed from the window or its class are never destroyed.
+using IconHandle = std::shared_ptr<std::remove_pointer_t<HICON>>;
 
-            hwnd = other.hwnd;
-            title = other.title;
-            className = other.className;
-            processName = other.processName;
-            processId = other.processId;
-            isVisible = other.isVisible;
-            isMinimized = other.isMinimized;
-            score = other.score;
-            destroyIcon = other.destroyIcon;
+// Icons loaded from executables, by image path. Windows of the same
+// executable share one icon, and so one atlas cell, while any is listed.
+using ExecutableIcons = std::unordered_map<std::wstring, std::weak_ptr<std::remove_pointer_t<HICON>>>;
 
-            if (other.icon) {
-                icon = destroyIcon ? CopyIcon(other.icon) : other.icon;
-            } else {
-                icon = nullptr;
-            }
-        }
-        return *this;
-    }
-
-    WindowInfo(WindowInfo&& other) noexcept
-        : hwnd(other.hwnd), title(std::move(other.title)),
-          className(std::move(other.className)),
-          processName(std::move(other.processName)),
-          processId(other.processId), isVisible(other.isVisible),
-          isMinimized(other.isMinimized), icon(other.icon),
-          destroyIcon(other.destroyIcon), score(other.score) {
-        other.icon = nullptr;
-        other.destroyIcon = false;
-    }
-
-    WindowInfo& operator=(WindowInfo&& other) noexcept {
-        if (this != &other) {
-            if (destroyIcon && icon) {
-                DestroyIcon(icon);
-            }
-
-            hwnd = other.hwnd;
-            title = std::move(other.title);
-            className = std::move(other.className);
-            processName = std::move(other.processName);
-            processId = other.processId;
-            isVisible = other.isVisible;
-            isMinimized = other.isMinimized;
-            icon = other.icon;
-            destroyIcon = other.destroyIcon;
-            score = other.score;
+// Window information structure. Process and class names are interned in
+// the StringPool of the snapshot the window belongs to; the title is the
+// bare window text, without the process name.
+struct WindowInfo {
+    HWND hwnd = nullptr;
+    std::wstring title;
+    StringPool::Id classNameId = 0;
+    StringPool::Id processNameId = 0;
+    DWORD processId = 0;
+    bool isVisible = false;
+    bool isMinimized = false;
+    IconHandle icon;
+};
 
-            other.icon = nullptr;
-            other.destroyIcon = false;
-        }
-        return *this;
-    }
+// Raw attributes of one top-level window, each read from the system once
+// per refresh. Filtering and WindowInfo construction both work from it.
+struct WindowCandidate {
+    HWND hwnd = nullptr;
+    LONG exStyle = 0;
+    HWND parent = nullptr;
+    bool isMinimized = false;
+    DWORD processId = 0;
+    wchar_t title[512];
+    int titleLength = 0;
+    wchar_t className[256];
+    int classNameLength = 0;
 };
 
 // Utility functions
 namespace Utils {
-    std::wstring GetProcessName(DWORD processId);
-    HICON GetWindowIcon(HWND hwnd, bool& destroyIcon);
+    // An icon owned by its window or class, which is never destroyed here
+    IconHandle BorrowIcon(HICON icon);
+    // Asks the window for its icon, waiting at most `timeoutMs` in all;
+    // false if it did not answer in time or is hung. A window that refuses
+    // the message counts as answered, without an icon.
+    bool QueryWindowIcon(HWND hwnd, UINT timeoutMs, HICON& icon);
+    // The window's own icon, or else its class's or its executable's. If
+    // the window misses the deadline, `timedOut` is set and the class or
+    // executable icon stands in.
+    IconHandle GetWindowIcon(HWND hwnd, DWORD processId, ExecutableIcons& executableIcons, UINT timeoutMs,
+                             bool& timedOut);
+    // Renders `icon` at size x size into premultiplied ARGB, rows top-down
+    bool RenderIcon(HICON icon, int size, std::vector<uint32_t>& pixels);
     void CenterWindow(HWND hwnd, int width, int height);
-    bool IsValidWindow(HWND hwnd);
+    // Fills `candidate`; false, with the rest unread, if `hwnd` is not a
+    // visible window (most top-level windows are not)
+    bool ReadWindow(HWND hwnd, WindowCandidate& candidate);
+    bool IsValidWindow(const WindowCandidate& candidate, const ProcessTable& processes);
+    bool IsValidWindow(HWND hwnd); // Reads the window and takes its own process snapshot
     UINT StringToVK(const std::wstring& key);
     UINT LoadHotkeySetting();
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "WinEventWindowSource.h"
+
+std::atomic<WinEventWindowSource*> WinEventWindowSource::s_instance{ nullptr };
+
+WinEventWindowSource::WinEventWindowSource()
+    : m_threadId(0)
+    , m_enumerating(nullptr) {
+}
+
+WinEventWindowSource::~WinEventWindowSource() {
+    Stop();
+}
+
+bool WinEventWindowSource::Start(ChangeHandler onChange) {
+    WinEventWindowSource* expected = nullptr;
+    if (!s_instance.compare_exchange_strong(expected, this)) {
+        return false; // Another source owns the hooks
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_onChange = std::move(onChange);
+    }
+
+    std::promise<bool> started;
+    std::future<bool> result = started.get_future();
+    m_thread = std::thread([this, &started] { HookThread(started); });
+    if (!result.get()) {
+        m_thread.join();
+        s_instance = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void WinEventWindowSource::Stop() {
+    if (m_thread.joinable()) {
+        PostThreadMessageW(m_threadId, WM_QUIT, 0, 0);
+        m_thread.join();
+        s_instance = nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_onChange = nullptr;
+}
+
+void WinEventWindowSource::HookThread(std::promise<bool>& started) {
+    // Out-of-context hooks deliver through this thread's message queue;
+    // create it before anyone can post WM_QUIT to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    m_threadId = GetCurrentThreadId();
+
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    const HWINEVENTHOOK hooks[] = {
+        SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE, nullptr, OnWinEvent, 0, 0, flags),
+        SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr, OnWinEvent, 0, 0, flags),
+        SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, OnWinEvent, 0, 0, flags),
+        SetWinEventHook(EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND, nullptr, OnWinEvent, 0, 0, flags),
+    };
+
+    bool hooked = true;
+    for (HWINEVENTHOOK hook : hooks) {
+        hooked &= hook != nullptr;
+    }
+    if (hooked) {
+        started.set_value(true);
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    for (HWINEVENTHOOK hook : hooks) {
+        if (hook) UnhookWinEvent(hook);
+    }
+    if (!hooked) {
+        started.set_value(false);
+    }
+}
+
+void CALLBACK WinEventWindowSource::OnWinEvent(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject, LONG idChild,
+                                               DWORD, DWORD) {
+    WinEventWindowSource* source = s_instance.load();
+    if (!source || !hwnd || idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
+    }
+
+    switch (event) {
+    case EVENT_OBJECT_DESTROY:
+        // Gone already, so there is no telling whether it was top-level
+        source->Queue(WindowEvent::Kind::Destroyed, hwnd);
+        return;
+    case EVENT_OBJECT_HIDE:
+        source->Queue(WindowEvent::Kind::Hidden, hwnd);
+        return;
+    default:
+        break;
+    }
+
+    // Child windows raise most of these; only top-level windows are listed
+    if (GetAncestor(hwnd, GA_ROOT) != hwnd) {
+        return;
+    }
+    switch (event) {
+    case EVENT_OBJECT_CREATE: source->Queue(WindowEvent::Kind::Created, hwnd); break;
+    case EVENT_OBJECT_SHOW: source->Queue(WindowEvent::Kind::Shown, hwnd); break;
+    case EVENT_OBJECT_NAMECHANGE: source->Queue(WindowEvent::Kind::NameChanged, hwnd); break;
+    case EVENT_SYSTEM_FOREGROUND: source->Queue(WindowEvent::Kind::Foreground, hwnd); break;
+    case EVENT_SYSTEM_MINIMIZESTART:
+    case EVENT_SYSTEM_MINIMIZEEND: source->Queue(WindowEvent::Kind::StateChanged, hwnd); break;
+    default: break;
+    }
+}
+
+void WinEventWindowSource::Queue(WindowEvent::Kind kind, HWND hwnd) {
+    ChangeHandler notify;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Only the first event of a batch wakes the consumer
+        if (m_events.empty()) notify = m_onChange;
+        m_events.push_back({ kind, reinterpret_cast<WindowHandle>(hwnd) });
+    }
+    if (notify) notify();
+}
+
+void WinEventWindowSource::TakeEvents(std::vector<WindowEvent>& events) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const WindowEvent& event : m_events) {
+        // A handle can be reused by a new window
+        if (event.kind == WindowEvent::Kind::Destroyed) m_seen.erase(event.handle);
+    }
+    events.insert(events.end(), m_events.begin(), m_events.end());
+    m_events.clear();
+}
+
+void WinEventWindowSource::Fill(const WindowCandidate& candidate, TrackedWindow& window) const {
+    window.handle = reinterpret_cast<WindowHandle>(candidate.hwnd);
+    window.processId = candidate.processId;
+    window.title.assign(candidate.title, candidate.titleLength);
+    window.processName = m_processes.Name(candidate.processId);
+    window.className.assign(candidate.className, candidate.classNameLength);
+    window.isMinimized = candidate.isMinimized;
+}
+
+bool WinEventWindowSource::Read(WindowHandle handle, TrackedWindow& window) {
+    WindowCandidate candidate;
+    if (!Utils::ReadWindow(reinterpret_cast<HWND>(handle), candidate)) {
+        m_seen.erase(handle);
+        return false;
+    }
+
+    Seen& seen = m_seen[handle];
+    if (seen.at == 0 || seen.processId != candidate.processId) {
+        seen = { candidate.processId, ProcessTable::Now() };
+    }
+    // A process started since the last snapshot, possibly under the id of
+    // one that has exited
+    if (!m_processes.Current(candidate.processId, seen.at)) {
+        m_processes.Refresh();
+    }
+    if (!Utils::IsValidWindow(candidate, m_processes)) {
+        return false;
+    }
+    Fill(candidate, window);
+    return true;
+}
+
+void WinEventWindowSource::Enumerate(std::vector<TrackedWindow>& windows) {
+    m_processes.Refresh(); // One process snapshot for the whole enumeration
+    m_seen.clear();
+    m_enumerating = &windows;
+    EnumWindows(EnumWindowsProc, reinterpret_cast<LPARAM>(this));
+    m_enumerating = nullptr;
+}
+
+BOOL CALLBACK WinEventWindowSource::EnumWindowsProc(HWND hwnd, LPARAM lParam) {
+    WinEventWindowSource* source = reinterpret_cast<WinEventWindowSource*>(lParam);
+
+    // Every attribute is read once, then filtered and copied from the record
+    WindowCandidate candidate;
+    if (Utils::ReadWindow(hwnd, candidate) && Utils::IsValidWindow(candidate, source->m_processes)) {
+        source->Fill(candidate, source->m_enumerating->emplace_back());
+        source->m_seen[reinterpret_cast<WindowHandle>(hwnd)] = { candidate.processId, ProcessTable::Now() };
+    }
+    
+    return TRUE; // Continue enumeration
+}
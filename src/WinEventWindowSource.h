@@ -0,0 +1,60 @@
+#pragma once
+
+#include "WindowSource.h"
+#include "ProcessTable.h"
+#include "Utils.h"
+#include <windows.h>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// WindowSource for the live desktop. A dedicated thread installs
+// out-of-context WinEvent hooks for top-level window creation,
+// destruction, visibility, title, foreground and minimize changes, and
+// queues them. Reads and enumeration apply the same rules as the list
+// always has (Utils::ReadWindow, Utils::IsValidWindow). Hook callbacks
+// carry no context, so only one instance can be started at a time.
+class WinEventWindowSource : public WindowSource {
+public:
+    WinEventWindowSource();
+    ~WinEventWindowSource() override;
+
+    bool Start(ChangeHandler onChange) override;
+    void Stop() override;
+    void TakeEvents(std::vector<WindowEvent>& events) override;
+    bool Read(WindowHandle handle, TrackedWindow& window) override;
+    void Enumerate(std::vector<TrackedWindow>& windows) override;
+
+private:
+    static void CALLBACK OnWinEvent(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject, LONG idChild,
+                                    DWORD eventThread, DWORD eventTime);
+    static BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam);
+
+    void HookThread(std::promise<bool>& started);
+    void Queue(WindowEvent::Kind kind, HWND hwnd);
+    void Fill(const WindowCandidate& candidate, TrackedWindow& window) const;
+
+    static std::atomic<WinEventWindowSource*> s_instance;
+
+    std::thread m_thread;
+    DWORD m_threadId;
+
+    std::mutex m_mutex;
+    std::vector<WindowEvent> m_events;
+    ChangeHandler m_onChange;
+
+    // When each window was first read or enumerated, and by which process,
+    // standing in for its creation time in ProcessTable::Current()
+    struct Seen {
+        DWORD processId = 0;
+        ULONGLONG at = 0;
+    };
+
+    // Read(), Enumerate() and TakeEvents() only, which run on the updater thread
+    ProcessTable m_processes;
+    std::unordered_map<WindowHandle, Seen> m_seen;
+    std::vector<TrackedWindow>* m_enumerating;
+};
@@ -0,0 +1,46 @@
+#include "WindowDiff.h"
+
+void WindowDelta::Clear() {
+    added.clear();
+    removed.clear();
+    changed.clear();
+    previous.clear();
+    reordered = false;
+}
+
+void WindowDiff::Compute(const std::vector<TrackedWindow>& before, const std::vector<TrackedWindow>& after,
+                         WindowDelta& delta) {
+    delta.Clear();
+
+    m_before.clear();
+    for (size_t i = 0; i < before.size(); ++i) {
+        m_before.emplace(before[i].handle, i);
+    }
+
+    m_kept.assign(before.size(), false);
+    delta.previous.resize(after.size(), WindowDelta::kNone);
+    size_t lastKept = 0;
+    for (size_t i = 0; i < after.size(); ++i) {
+        const TrackedWindow& window = after[i];
+        const auto it = m_before.find(window.handle);
+        if (it == m_before.end() || before[it->second].processId != window.processId) {
+            delta.added.push_back(i);
+            continue;
+        }
+
+        const size_t old = it->second;
+        delta.previous[i] = old;
+        m_kept[old] = true;
+        if (before[old] != window) {
+            delta.changed.push_back(i);
+        }
+        if (old < lastKept) {
+            delta.reordered = true;
+        }
+        lastKept = old;
+    }
+
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (!m_kept[i]) delta.removed.push_back(i);
+    }
+}
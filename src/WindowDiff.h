@@ -0,0 +1,33 @@
+#pragma once
+
+#include "WindowSource.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// What changed between two window lists. Windows are matched by handle
+// and process id, so a handle that was freed and reused by another
+// process counts as one window removed and another added.
+struct WindowDelta {
+    static constexpr size_t kNone = SIZE_MAX;
+
+    std::vector<size_t> added;    // Indices into the new list, ascending
+    std::vector<size_t> removed;  // Indices into the old list, ascending
+    std::vector<size_t> changed;  // Indices into the new list of kept windows whose attributes differ, ascending
+    std::vector<size_t> previous; // For each entry of the new list, its index in the old one, or kNone if added
+    bool reordered = false;       // Kept windows are no longer in the same relative order
+
+    bool Empty() const { return added.empty() && removed.empty() && changed.empty() && !reordered; }
+    void Clear();
+};
+
+class WindowDiff {
+public:
+    void Compute(const std::vector<TrackedWindow>& before, const std::vector<TrackedWindow>& after,
+                 WindowDelta& delta);
+
+private:
+    std::unordered_map<WindowHandle, size_t> m_before; // Scratch, kept for its buckets
+    std::vector<bool> m_kept;
+};
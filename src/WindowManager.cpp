@@ -1,129 +1,229 @@
-#include "WindowManager.h"
-#include "Utils.h"
-#include <algorithm>
-
-WindowManager::WindowManager() {
-}
-
-WindowManager::~WindowManager() {
-}
-
-std::vector<WindowInfo> WindowManager::GetAllWindows() {
-    m_windows.clear();
-    EnumWindows(EnumWindowsProc, reinterpret_cast<LPARAM>(this));
-    return m_windows;
-}
-
-bool WindowManager::ActivateWindow(HWND hwnd) {
-    if (!IsWindowValid(hwnd)) {
-        return false;
-    }
-
-    bool wasIconic = IsIconic(hwnd);
-
-    // Simulate a key press to allow SetForegroundWindow to work
-    keybd_event(VK_MENU, 0, KEYEVENTF_EXTENDEDKEY, 0);
-    keybd_event(VK_MENU, 0, KEYEVENTF_EXTENDEDKEY | KEYEVENTF_KEYUP, 0);
-
-    // If window is minimized, restore it first
-    if (wasIconic) {
-        ShowWindow(hwnd, SW_RESTORE);
-    }
-    
-    // To handle cases where SetForegroundWindow might fail, 
-    // we can attach our thread's input to the target window's thread.
-    DWORD currentThreadId = GetCurrentThreadId();
-    DWORD targetThreadId = GetWindowThreadProcessId(hwnd, nullptr);
-
-    if (currentThreadId != targetThreadId) {
-        AttachThreadInput(currentThreadId, targetThreadId, TRUE);
-        SetForegroundWindow(hwnd);
-        SetFocus(hwnd);
-        AttachThreadInput(currentThreadId, targetThreadId, FALSE);
-    } else {
-        SetForegroundWindow(hwnd);
-        SetFocus(hwnd);
-    }
-    
-    // This is a common trick to force a window to the top of the Z-order,
-    // ensuring it appears correctly in the Alt-Tab list.
-    // We briefly make it the topmost window, then remove that status,
-    // which pushes it to the top of the non-topmost stack.
-    SetWindowPos(hwnd, HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
-    SetWindowPos(hwnd, HWND_NOTOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
-
-    // After activating, always center the cursor in the window
-    // to ensure compatibility with mouse-driven tilers.
-    RECT rc;
-    if (GetWindowRect(hwnd, &rc)) {
-        SetCursorPos(rc.left + (rc.right - rc.left) / 2, rc.top + (rc.bottom - rc.top) / 2);
-    }
-
-    return true;
-}
-
-bool WindowManager::IsWindowValid(HWND hwnd) {
-    return Utils::IsValidWindow(hwnd);
-}
-
-void WindowManager::RefreshWindows() {
-    GetAllWindows();
-}
-
-BOOL CALLBACK WindowManager::EnumWindowsProc(HWND hwnd, LPARAM lParam) {
-    WindowManager* manager = reinterpret_cast<WindowManager*>(lParam);
-    
-    if (manager->ShouldIncludeWindow(hwnd)) {
-        WindowInfo info = manager->CreateWindowInfo(hwnd);
-        manager->m_windows.push_back(info);
-    }
-    
-    return TRUE; // Continue enumeration
-}
-
-WindowInfo WindowManager::CreateWindowInfo(HWND hwnd) {
-    WindowInfo info;
-    info.hwnd = hwnd;
-    info.title = GetWindowTitle(hwnd);
-    info.className = GetWindowClassName(hwnd);
-    
-    // Get process ID and name
-    GetWindowThreadProcessId(hwnd, &info.processId);
-    info.processName = Utils::GetProcessName(info.processId);
-    
-    // Append process name to title for better searchability
-    if (!info.processName.empty()) {
-        info.title += L" (" + info.processName + L")";
-    }
-
-    // Window state
-    info.isVisible = IsWindowVisible(hwnd) != FALSE;
-    info.isMinimized = IsIconic(hwnd) != FALSE;
-
-    // Get icon
-    info.icon = Utils::GetWindowIcon(hwnd, info.destroyIcon);
-    
-    return info;
-}
-
-bool WindowManager::ShouldIncludeWindow(HWND hwnd) {
-    return Utils::IsValidWindow(hwnd);
-}
-
-std::wstring WindowManager::GetWindowTitle(HWND hwnd) {
-    wchar_t title[512];
-    int length = GetWindowTextW(hwnd, title, 512);
-    if (length > 0) {
-        return std::wstring(title, length);
-    }
-    return L"";
-}
-
-std::wstring WindowManager::GetWindowClassName(HWND hwnd) {
-    wchar_t className[256];
-    int length = GetClassNameW(hwnd, className, 256);
-    if (length > 0) {
-        return std::wstring(className, length);
-    }
-    return L"";
-} 
\ No newline at end of file
+#include "WindowManager.h"
+#include "Utils.h"
+#include <algorithm>
+
+WindowManager::WindowManager(std::function<void()> onIconsFetched)
+    : m_names(std::make_shared<StringPool>())
+    , m_iconFetcher(std::make_unique<IconFetcher>(std::move(onIconsFetched))) {
+}
+
+WindowManager::~WindowManager() {
+}
+
+bool WindowManager::Update(const std::vector<TrackedWindow>& windows, WindowDelta& delta) {
+    m_diff.Compute(m_tracked, windows, delta);
+    if (delta.Empty()) {
+        return false;
+    }
+
+    // Published snapshots hold copies, so the old entries can be moved from
+    std::vector<WindowInfo> updated;
+    updated.reserve(windows.size());
+    auto changed = delta.changed.begin();
+    for (size_t i = 0; i < windows.size(); ++i) {
+        const size_t previous = delta.previous[i];
+        if (previous == WindowDelta::kNone) {
+            updated.push_back(CreateWindowInfo(windows[i]));
+            continue;
+        }
+
+        updated.push_back(std::move(m_windows[previous]));
+        if (changed != delta.changed.end() && *changed == i) {
+            UpdateWindowInfo(updated.back(), m_tracked[previous], windows[i]);
+            ++changed;
+        }
+    }
+    for (size_t removed : delta.removed) {
+        m_placeholderIcons.erase(reinterpret_cast<HWND>(m_tracked[removed].handle));
+        m_pendingIcons.erase(reinterpret_cast<HWND>(m_tracked[removed].handle));
+    }
+
+    m_windows = std::move(updated);
+    m_tracked = windows;
+    if (!delta.removed.empty()) {
+        CompactNames();
+    }
+
+    // Executables whose windows have all closed, and whose icons are gone with them
+    if (!delta.removed.empty()) {
+        for (auto it = m_executableIcons.begin(); it != m_executableIcons.end();) {
+            it = it->second.expired() ? m_executableIcons.erase(it) : std::next(it);
+        }
+    }
+    return true;
+}
+
+void WindowManager::RequestIcons(const std::vector<WindowEvent>& events) {
+    for (const WindowEvent& event : events) {
+        const HWND hwnd = reinterpret_cast<HWND>(event.handle);
+        if ((event.kind == WindowEvent::Kind::Shown || event.kind == WindowEvent::Kind::NameChanged) &&
+            m_placeholderIcons.count(hwnd)) {
+            RequestIcon(hwnd);
+        }
+    }
+}
+
+void WindowManager::RequestIcons() {
+    for (HWND hwnd : m_placeholderIcons) {
+        RequestIcon(hwnd);
+    }
+}
+
+void WindowManager::RequestIcon(HWND hwnd) {
+    m_pendingIcons.insert(hwnd);
+    m_iconFetcher->Request(hwnd);
+}
+
+bool WindowManager::ApplyFetchedIcons() {
+    m_fetched.clear();
+    m_iconFetcher->TakeResults(m_fetched);
+
+    bool applied = false;
+    for (const IconFetcher::Result& result : m_fetched) {
+        // Gone from the list since
+        if (!m_pendingIcons.erase(result.hwnd)) continue;
+        // Any answer is final; without an icon of its own, the window keeps
+        // its class's or executable's, as if it had answered in time
+        m_placeholderIcons.erase(result.hwnd);
+        if (!result.icon) continue;
+        for (WindowInfo& info : m_windows) {
+            if (info.hwnd == result.hwnd) {
+                info.icon = Utils::BorrowIcon(result.icon);
+                applied = true;
+                break;
+            }
+        }
+    }
+    return applied;
+}
+
+bool WindowManager::ActivateWindow(HWND hwnd) {
+    if (!IsWindowValid(hwnd)) {
+        return false;
+    }
+
+    bool wasIconic = IsIconic(hwnd);
+
+    // Simulate a key press to allow SetForegroundWindow to work
+    keybd_event(VK_MENU, 0, KEYEVENTF_EXTENDEDKEY, 0);
+    keybd_event(VK_MENU, 0, KEYEVENTF_EXTENDEDKEY | KEYEVENTF_KEYUP, 0);
+
+    // If window is minimized, restore it first
+    if (wasIconic) {
+        ShowWindow(hwnd, SW_RESTORE);
+    }
+    
+    // To handle cases where SetForegroundWindow might fail, 
+    // we can attach our thread's input to the target window's thread.
+    DWORD currentThreadId = GetCurrentThreadId();
+    DWORD targetThreadId = GetWindowThreadProcessId(hwnd, nullptr);
+
+    if (currentThreadId != targetThreadId) {
+        AttachThreadInput(currentThreadId, targetThreadId, TRUE);
+        SetForegroundWindow(hwnd);
+        SetFocus(hwnd);
+        AttachThreadInput(currentThreadId, targetThreadId, FALSE);
+    } else {
+        SetForegroundWindow(hwnd);
+        SetFocus(hwnd);
+    }
+    
+    // This is a common trick to force a window to the top of the Z-order,
+    // ensuring it appears correctly in the Alt-Tab list.
+    // We briefly make it the topmost window, then remove that status,
+    // which pushes it to the top of the non-topmost stack.
+    SetWindowPos(hwnd, HWND_TOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
+    SetWindowPos(hwnd, HWND_NOTOPMOST, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE);
+
+    // After activating, always center the cursor in the window
+    // to ensure compatibility with mouse-driven tilers.
+    RECT rc;
+    if (GetWindowRect(hwnd, &rc)) {
+        SetCursorPos(rc.left + (rc.right - rc.left) / 2, rc.top + (rc.bottom - rc.top) / 2);
+    }
+
+    return true;
+}
+
+bool WindowManager::IsWindowValid(HWND hwnd) {
+    return Utils::IsValidWindow(hwnd);
+}
+
+WindowInfo WindowManager::CreateWindowInfo(const TrackedWindow& window) {
+    WindowInfo info;
+    info.hwnd = reinterpret_cast<HWND>(window.handle);
+    info.title = window.title;
+    info.classNameId = Intern(window.className);
+    info.processId = window.processId;
+    info.processNameId = Intern(window.processName);
+
+    // Window state; only visible windows are tracked
+    info.isVisible = true;
+    info.isMinimized = window.isMinimized;
+
+    // A slow window is listed now, with a placeholder icon until its own arrives
+    bool timedOut = false;
+    info.icon = Utils::GetWindowIcon(info.hwnd, info.processId, m_executableIcons,
+                                     static_cast<UINT>(std::max(Config::MESSAGE_TIMEOUT_MS, 1)), timedOut);
+    if (timedOut) {
+        ++m_timedOutWindows;
+        m_placeholderIcons.insert(info.hwnd);
+        RequestIcon(info.hwnd);
+    }
+    return info;
+}
+
+void WindowManager::UpdateWindowInfo(WindowInfo& info, const TrackedWindow& before, const TrackedWindow& after) {
+    // Same window, same process: the icon stays, the rest is refreshed as needed
+    if (after.title != before.title) info.title = after.title;
+    if (after.className != before.className) info.classNameId = Intern(after.className);
+    if (after.processName != before.processName) info.processNameId = Intern(after.processName);
+    info.isMinimized = after.isMinimized;
+
+    // Doing something again; it may answer this time
+    if (m_placeholderIcons.count(info.hwnd)) {
+        RequestIcon(info.hwnd);
+    }
+}
+
+StringPool::Id WindowManager::Intern(std::wstring_view text) {
+    const StringPool::Id id = m_names->Find(text);
+    if (id != StringPool::kMissing) return id;
+
+    // Published snapshots share the pool; the first new name copies it
+    if (m_namesPublished) {
+        m_names = std::make_shared<StringPool>(*m_names);
+        m_namesPublished = false;
+    }
+    return m_names->Intern(text);
+}
+
+void WindowManager::CompactNames() {
+    // Names of closed windows pile up; once they outnumber the live ones by
+    // far, move the live ones to a fresh pool, which copies stay small
+    constexpr size_t kSlack = 64;
+    std::vector<bool> live(m_names->Size(), false);
+    size_t liveCount = 0;
+    for (const WindowInfo& info : m_windows) {
+        for (StringPool::Id id : { info.classNameId, info.processNameId }) {
+            if (!live[id]) {
+                live[id] = true;
+                ++liveCount;
+            }
+        }
+    }
+    if (m_names->Size() <= 2 * liveCount + kSlack) return;
+
+    auto compacted = std::make_shared<StringPool>();
+    for (WindowInfo& info : m_windows) {
+        info.classNameId = compacted->Intern(m_names->Get(info.classNameId));
+        info.processNameId = compacted->Intern(m_names->Get(info.processNameId));
+    }
+    m_names = std::move(compacted);
+    m_namesPublished = false;
+}
+
+std::shared_ptr<const StringPool> WindowManager::PublishNames() {
+    m_namesPublished = true;
+    return m_names;
+}
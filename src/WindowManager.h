@@ -1,33 +1,65 @@
-#pragma once
-
-#include "Utils.h"
-#include <vector>
-#include <functional>
-
-class WindowManager {
-public:
-    WindowManager();
-    ~WindowManager();
-
-    // Get all windows
-    std::vector<WindowInfo> GetAllWindows();
-    
-    // Window operations
-    bool ActivateWindow(HWND hwnd);
-    bool IsWindowValid(HWND hwnd);
-    
-    // Refresh window list
-    void RefreshWindows();
-    
-private:
-    std::vector<WindowInfo> m_windows;
-    
-    // Static callback for EnumWindows
-    static BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam);
-    
-    // Helper methods
-    WindowInfo CreateWindowInfo(HWND hwnd);
-    bool ShouldIncludeWindow(HWND hwnd);
-    std::wstring GetWindowTitle(HWND hwnd);
-    std::wstring GetWindowClassName(HWND hwnd);
+#pragma once
+
+#include "Utils.h"
+#include "StringPool.h"
+#include "WindowSource.h"
+#include "WindowDiff.h"
+#include "IconFetcher.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <functional>
+#include <memory>
+
+class WindowManager {
+public:
+    // `onIconsFetched` is called, on another thread, when icons that
+    // missed their deadline arrive; ApplyFetchedIcons() takes them in
+    explicit WindowManager(std::function<void()> onIconsFetched = nullptr);
+    ~WindowManager();
+
+    // Brings the list up to date with the tracked windows. Entries of
+    // windows that are still there are kept, icons included; only new
+    // windows are read from scratch. `delta` says what changed; false if
+    // nothing did, in which case the list is untouched.
+    bool Update(const std::vector<TrackedWindow>& windows, WindowDelta& delta);
+    const std::vector<WindowInfo>& Windows() const { return m_windows; }
+
+    // Asks windows that missed the icon deadline, and have not answered
+    // since, again when they are shown or renamed, as they may be less busy
+    void RequestIcons(const std::vector<WindowEvent>& events);
+    // Asks all of them, e.g. after a reconciliation
+    void RequestIcons();
+    // Replaces placeholder icons with those that arrived late; true if any did
+    bool ApplyFetchedIcons();
+    // Windows that missed the icon deadline, since startup
+    uint64_t TimedOutWindows() const { return m_timedOutWindows; }
+    // Names the windows from Windows() refer to, to publish along with
+    // them. The pool is never changed after this; the next Update() that
+    // needs a new name works on a copy.
+    std::shared_ptr<const StringPool> PublishNames();
+    
+    // Window operations
+    bool ActivateWindow(HWND hwnd);
+    bool IsWindowValid(HWND hwnd);
+    
+private:
+    std::vector<WindowInfo> m_windows;
+    std::vector<TrackedWindow> m_tracked; // What m_windows was built from
+    std::shared_ptr<StringPool> m_names;
+    bool m_namesPublished = false; // Handed out by PublishNames(), copy before writing
+    ExecutableIcons m_executableIcons;
+    std::unordered_set<HWND> m_placeholderIcons; // Missed the icon deadline, no answer yet
+    std::unordered_set<HWND> m_pendingIcons;     // Of those, the ones asked again
+    uint64_t m_timedOutWindows = 0;
+    std::vector<IconFetcher::Result> m_fetched;
+    std::unique_ptr<IconFetcher> m_iconFetcher; // Last, so that its thread stops first
+    WindowDiff m_diff;
+    
+    // Helper methods
+    WindowInfo CreateWindowInfo(const TrackedWindow& window);
+    void UpdateWindowInfo(WindowInfo& info, const TrackedWindow& before, const TrackedWindow& after);
+    void RequestIcon(HWND hwnd);
+    StringPool::Id Intern(std::wstring_view text);
+    void CompactNames();
 }; 
\ No newline at end of file
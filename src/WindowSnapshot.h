@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Utils.h"
+#include "SearchSnapshot.h"
+#include "StringPool.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One published window list together with its search data. Never modified
+// after the updater publishes it; the UI keeps the snapshot its results
+// index into alive for as long as it displays them.
+struct WindowSnapshot : SearchSnapshot {
+    std::vector<WindowInfo> windows;
+    std::shared_ptr<const StringPool> names; // Process and class names of `windows`
+    uint64_t timedOutWindows = 0;            // Windows that missed the icon deadline, since startup
+
+    const std::wstring& ProcessName(const WindowInfo& window) const { return names->Get(window.processNameId); }
+
+    // The title as listed and searched: "title (process.exe)"
+    void SearchTitle(const WindowInfo& window, std::wstring& out) const {
+        out.assign(window.title);
+        const std::wstring& process = ProcessName(window);
+        if (!process.empty()) {
+            out.append(L" (").append(process).append(L")");
+        }
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Where the switcher's window list comes from, independent of Win32: a
+// stream of change events plus the means to read one window or enumerate
+// them all. WinEventWindowSource watches the desktop through WinEvent
+// hooks; ScriptedWindowSource plays a scripted desktop in memory.
+// WindowTracker turns either into an up-to-date list.
+
+using WindowHandle = uintptr_t;
+
+// What the switcher lists about a window, as read from the source
+struct TrackedWindow {
+    WindowHandle handle = 0;
+    uint32_t processId = 0;
+    std::wstring title;       // Bare window text
+    std::wstring processName;
+    std::wstring className;
+    bool isMinimized = false;
+
+    bool operator==(const TrackedWindow& other) const {
+        return handle == other.handle && processId == other.processId && isMinimized == other.isMinimized &&
+               title == other.title && processName == other.processName && className == other.className;
+    }
+    bool operator!=(const TrackedWindow& other) const { return !(*this == other); }
+};
+
+struct WindowEvent {
+    enum class Kind {
+        Created,
+        Destroyed,
+        Shown,
+        Hidden,
+        NameChanged,
+        Foreground,   // Became the foreground window
+        StateChanged, // Minimized or restored
+    };
+
+    Kind kind = Kind::Created;
+    WindowHandle handle = 0;
+};
+
+class WindowSource {
+public:
+    using ChangeHandler = std::function<void()>;
+
+    virtual ~WindowSource() = default;
+
+    // Starts watching; `onChange` is called, on any thread, when events
+    // start waiting. Returns false if the source cannot deliver events, in
+    // which case only Enumerate() is meaningful.
+    virtual bool Start(ChangeHandler onChange) = 0;
+    virtual void Stop() = 0;
+
+    // Moves the waiting events, oldest first, to the end of `events`
+    virtual void TakeEvents(std::vector<WindowEvent>& events) = 0;
+
+    // Reads one window; false if it is gone or should not be listed
+    virtual bool Read(WindowHandle handle, TrackedWindow& window) = 0;
+
+    // Every window that should be listed, topmost first
+    virtual void Enumerate(std::vector<TrackedWindow>& windows) = 0;
+};
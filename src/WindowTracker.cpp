@@ -0,0 +1,90 @@
+#include "WindowTracker.h"
+#include <algorithm>
+
+WindowTracker::WindowTracker(WindowSource& source)
+    : m_source(source) {
+}
+
+size_t WindowTracker::Find(WindowHandle handle) const {
+    for (size_t i = 0; i < m_windows.size(); ++i) {
+        if (m_windows[i].handle == handle) return i;
+    }
+    return SIZE_MAX;
+}
+
+void WindowTracker::MoveToTop(size_t index) {
+    std::rotate(m_windows.begin(), m_windows.begin() + static_cast<std::ptrdiff_t>(index),
+                m_windows.begin() + static_cast<std::ptrdiff_t>(index) + 1);
+}
+
+bool WindowTracker::Apply(const std::vector<WindowEvent>& events) {
+    if (events.empty()) return false;
+
+    // What each window's events add up to: whether it ends up raised
+    m_touched.clear();
+    for (size_t i = 0; i < events.size(); ++i) {
+        Touched& touched = m_touched[events[i].handle];
+        switch (events[i].kind) {
+        case WindowEvent::Kind::Created:
+        case WindowEvent::Kind::Shown:
+        case WindowEvent::Kind::Foreground:
+            touched.lastRaise = i;
+            break;
+        case WindowEvent::Kind::Destroyed:
+        case WindowEvent::Kind::Hidden:
+            touched.lastRaise = SIZE_MAX;
+            break;
+        case WindowEvent::Kind::NameChanged:
+        case WindowEvent::Kind::StateChanged:
+            break;
+        }
+    }
+
+    // One read per window, in the order the windows first appear; the
+    // source decides whether a window is (still) listed
+    bool changed = false;
+    for (const WindowEvent& event : events) {
+        Touched& touched = m_touched[event.handle];
+        if (touched.read) continue;
+        touched.read = true;
+
+        const size_t index = Find(event.handle);
+        if (m_source.Read(event.handle, m_read)) {
+            if (index == SIZE_MAX) {
+                m_windows.insert(m_windows.begin(), m_read); // New windows open on top
+                changed = true;
+            } else if (m_windows[index] != m_read) {
+                m_windows[index] = m_read;
+                changed = true;
+            }
+        } else if (index != SIZE_MAX) {
+            m_windows.erase(m_windows.begin() + static_cast<std::ptrdiff_t>(index));
+            changed = true;
+        }
+    }
+
+    // The most recently raised window ends up first
+    m_raised.clear();
+    for (const auto& [handle, touched] : m_touched) {
+        if (touched.lastRaise != SIZE_MAX) m_raised.emplace_back(touched.lastRaise, handle);
+    }
+    std::sort(m_raised.begin(), m_raised.end());
+    for (const auto& raised : m_raised) {
+        const size_t index = Find(raised.second);
+        if (index != SIZE_MAX && index != 0) {
+            MoveToTop(index);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool WindowTracker::Reconcile() {
+    m_enumerated.clear();
+    m_source.Enumerate(m_enumerated);
+    if (m_enumerated == m_windows) return false;
+
+    if (!m_windows.empty()) ++m_corrections; // Not for the first fill
+    std::swap(m_windows, m_enumerated);
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "WindowSource.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Keeps the list of switchable windows current from a WindowSource's
+// events. Each event batch re-reads only the windows it names, once each,
+// however many events a window raised. Created, shown, restored and
+// foreground windows move to the top, so the list stays close to z-order
+// without enumerating. A periodic Reconcile() enumerates everything and
+// corrects whatever the events missed, including the exact z-order.
+// Not thread-safe; the source may raise events on any thread.
+class WindowTracker {
+public:
+    explicit WindowTracker(WindowSource& source);
+
+    // Applies a batch of events; true if the list changed
+    bool Apply(const std::vector<WindowEvent>& events);
+
+    // Replaces the list with a full enumeration; true if it differed
+    bool Reconcile();
+
+    // Topmost first
+    const std::vector<TrackedWindow>& Windows() const { return m_windows; }
+
+    // Reconcile() passes that found the event-driven list out of date
+    uint64_t Corrections() const { return m_corrections; }
+
+private:
+    size_t Find(WindowHandle handle) const;
+    void MoveToTop(size_t index);
+
+    WindowSource& m_source;
+    std::vector<TrackedWindow> m_windows;
+    uint64_t m_corrections = 0;
+
+    // Per-batch scratch
+    struct Touched {
+        size_t lastRaise = SIZE_MAX; // Index of the last raising event, SIZE_MAX if none
+        bool read = false;
+    };
+    std::unordered_map<WindowHandle, Touched> m_touched;
+    std::vector<std::pair<size_t, WindowHandle>> m_raised;
+    std::vector<TrackedWindow> m_enumerated;
+    TrackedWindow m_read;
+};
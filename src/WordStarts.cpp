@@ -0,0 +1,68 @@
+#include "WordStarts.h"
+#include "CaseFold.h"
+#include <algorithm>
+
+namespace {
+    enum class Kind { Separator, Digit, Lower, Upper };
+
+    Kind Classify(wchar_t c) {
+        if (WordBoundaries::IsSeparator(c)) return Kind::Separator;
+        if (c >= L'0' && c <= L'9') return Kind::Digit;
+        // Anything case folding changes is an upper-case letter; scripts
+        // without case count as lower so they never form humps
+        return CaseFold::FoldCase(c) != c ? Kind::Upper : Kind::Lower;
+    }
+}
+
+namespace WordBoundaries {
+    bool IsSeparator(wchar_t c) {
+        const auto code = static_cast<uint32_t>(c);
+        if (code < 0x80) {
+            return !((c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9'));
+        }
+        return code == 0x00A0 ||                      // No-break space
+               (code >= 0x00A1 && code <= 0x00BF) ||  // Latin-1 punctuation and symbols
+               code == 0x00D7 || code == 0x00F7 ||    // Multiplication and division signs
+               (code >= 0x2000 && code <= 0x2BFF) ||  // Spaces, punctuation, arrows, symbols, dingbats
+               (code >= 0x3000 && code <= 0x303F) ||  // CJK punctuation
+               (code >= 0xFE30 && code <= 0xFE4F) ||  // CJK compatibility forms
+               (code >= 0xFF01 && code <= 0xFF0F) ||  // Fullwidth punctuation
+               (code >= 0xFF1A && code <= 0xFF20) ||
+               code == 0xFEFF;
+    }
+
+    bool IsSpace(wchar_t c) {
+        return c == L' ' || c == L'\t' || c == 0x00A0 || (c >= 0x2000 && c <= 0x200A) || c == 0x3000;
+    }
+
+    size_t Find(const wchar_t* text, size_t length, std::vector<uint16_t>& starts) {
+        const size_t before = starts.size();
+        const size_t end = std::min(length, kMaxOffset + 1);
+
+        Kind previous = Kind::Separator;
+        for (size_t i = 0; i < end; ++i) {
+            const Kind kind = Classify(text[i]);
+            bool start = false;
+            switch (kind) {
+            case Kind::Separator:
+                break;
+            case Kind::Digit:
+                start = previous != Kind::Digit;
+                break;
+            case Kind::Lower:
+                start = previous == Kind::Separator || previous == Kind::Digit;
+                break;
+            case Kind::Upper:
+                // "tabSwitcher" splits before 'S'; "HTMLParser" before 'P'
+                start = previous != Kind::Upper ||
+                        (i + 1 < length && Classify(text[i + 1]) == Kind::Lower);
+                break;
+            }
+            if (start) {
+                starts.push_back(static_cast<uint16_t>(i));
+            }
+            previous = kind;
+        }
+        return starts.size() - before;
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Offsets of the characters that begin a word in a title or process name:
+// the first character, any character after whitespace, punctuation or a
+// path separator, camelCase humps ("tabSwitcher", "HTMLParser") and the
+// switch between letters and digits ("win32"). Found on the original text,
+// since folding erases the humps; folding keeps offsets valid.
+struct WordStarts {
+    const uint16_t* offsets = nullptr;
+    size_t count = 0;
+};
+
+namespace WordBoundaries {
+    // Offsets past this limit are not recorded
+    constexpr size_t kMaxOffset = UINT16_MAX;
+
+    bool IsSeparator(wchar_t c);
+
+    // Spaces and tabs. Matches may start after them even where no word
+    // does, e.g. before the punctuation in "(3) Inbox" or "#general | Slack"
+    bool IsSpace(wchar_t c);
+
+    // Appends the word starts of `text` to `starts`, returns how many
+    size_t Find(const wchar_t* text, size_t length, std::vector<uint16_t>& starts);
+}